@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <regex>
+#include "Bench.h"
+
+namespace {
+  thread_local uint64_t allocs = 0;
+  thread_local uint64_t allocBytes = 0;
+}
+
+/* Count every allocation of the binary, frees are not needed for per-op numbers */
+void* operator new(size_t size) {
+  allocs ++;
+  allocBytes += size;
+  if (void *ptr = malloc(size ? size : 1)) return ptr;
+  throw bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  free(ptr);
+}
+
+namespace fuzzbench {
+  uint64_t allocations() {
+    return allocs;
+  }
+
+  uint64_t allocatedBytes() {
+    return allocBytes;
+  }
+
+  void Bench::add(string name, BenchFunc func) {
+    benches.push_back(make_pair(name, func));
+  }
+
+  vector<BenchResult> Bench::run(const string &filter, double minTime) {
+    regex pattern(filter);
+    vector<BenchResult> results;
+    for (auto &bench : benches) {
+      if (!filter.empty() && !regex_search(bench.first, pattern)) continue;
+      /* Warm up caches and tables built on first use */
+      bench.second(1);
+      uint64_t n = 1;
+      while (true) {
+        auto startAllocs = allocations();
+        auto startBytes = allocatedBytes();
+        auto start = chrono::steady_clock::now();
+        uint64_t ops = bench.second(n);
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (elapsed >= minTime || n >= (1ull << 40)) {
+          BenchResult result;
+          result.name = bench.first;
+          result.ops = max<uint64_t>(ops, 1);
+          result.seconds = elapsed;
+          result.nsPerOp = elapsed * 1e9 / result.ops;
+          result.allocsPerOp = (double) (allocations() - startAllocs) / result.ops;
+          result.bytesPerOp = (double) (allocatedBytes() - startBytes) / result.ops;
+          results.push_back(result);
+          break;
+        }
+        /* Aim past minTime from the last batch, growing at most 10 times */
+        double scale = elapsed > 0 ? minTime * 1.4 / elapsed : 10;
+        n = max<uint64_t>(n + 1, (uint64_t) (n * min(scale, 10.0)));
+      }
+    }
+    return results;
+  }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace fuzzbench {
+  /* Runs about n operations and returns how many it ran, a stage may overshoot */
+  using BenchFunc = function<uint64_t (uint64_t n)>;
+  struct BenchResult {
+    string name;
+    uint64_t ops = 0;
+    double seconds = 0;
+    double nsPerOp = 0;
+    double allocsPerOp = 0;
+    double bytesPerOp = 0;
+  };
+  class Bench {
+    vector<pair<string, BenchFunc>> benches;
+    public:
+      void add(string name, BenchFunc func);
+      /*
+       * Runs every benchmark whose name matches filter (all if empty). Each one is
+       * warmed up once, then its batch grows until a batch lasts at least minTime
+       * seconds, and that last batch is reported.
+       */
+      vector<BenchResult> run(const string &filter, double minTime);
+  };
+  /* Allocations and bytes requested by the calling thread, counted by the replaced operator new */
+  uint64_t allocations();
+  uint64_t allocatedBytes();
+}
@@ -0,0 +1,221 @@
+#include <ctime>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <libfuzzer/Fuzzer.h>
+#include <libfuzzer/Mutation.h>
+#include <libfuzzer/BytecodeBranch.h>
+#include <fuzzer/Utils.h>
+#include "Bench.h"
+
+using namespace std;
+using namespace fuzzer;
+using namespace fuzzbench;
+
+static double DEFAULT_MIN_TIME = 0.5;
+static uint64_t DEFAULT_SEED = 1;
+static int CORPUS_SIZE = 16;
+static string DEFAULT_ASSETS_FOLDER = "assets/";
+static string DEFAULT_ATTACKER = "ReentrancyAttacker";
+
+/* A deployed contract with a fixed corpus, shared by all benchmarks of that contract */
+struct Fixture {
+  ContractInfo info;
+  string name;
+  unique_ptr<TargetContainer> container;
+  unique_ptr<TargetExecutive> executive;
+  tuple<unordered_set<uint64_t>, unordered_set<uint64_t>> validJumpis;
+  Dictionary codeDict;
+  Dictionary addressDict;
+  vector<bytes> corpus;
+};
+
+static unique_ptr<Fixture> loadFixture(ContractInfo info, const vector<ContractInfo> &assets, const string &attackerName, Random &rng) {
+  unique_ptr<Fixture> fixture(new Fixture());
+  fixture->info = info;
+  fixture->name = info.contractName.substr(info.contractName.find(':') + 1);
+  fixture->container.reset(new TargetContainer());
+  /* Deploy the attacker first, as Fuzzer::start does */
+  for (auto asset : assets) {
+    if (asset.contractName.find(attackerName) == string::npos) continue;
+    ContractABI ca(asset.abiJson);
+    auto executive = fixture->container->loadContract(fromHex(asset.bin), ca);
+    executive.deploy(ContractABI::postprocessTestData(ca.randomTestcase("")), EMPTY_ONOP);
+    fixture->addressDict.fromAddress(executive.addr.asBytes());
+  }
+  auto bin = fromHex(info.bin);
+  ContractABI ca(info.abiJson);
+  fixture->codeDict.fromCode(bin);
+  fixture->validJumpis = BytecodeBranch(info).findValidJumpis();
+  fixture->executive.reset(new TargetExecutive(fixture->container->loadContract(bin, ca)));
+  /* The zero testcase followed by random contents, lengths are kept */
+  auto seed = ContractABI::postprocessTestData(ca.randomTestcase(""));
+  fixture->corpus.push_back(seed);
+  for (int i = 1; i < CORPUS_SIZE; i ++) {
+    auto data = seed;
+    for (size_t j = 96; j < data.size(); j ++) data[j] = (byte) rng.below(256);
+    fixture->corpus.push_back(ContractABI::postprocessTestData(data));
+  }
+  return fixture;
+}
+
+/* Main contracts are the .sol files of a folder, or a single .sol file, with their compiled .sol.json next to them */
+static vector<ContractInfo> findContracts(const string &target) {
+  vector<ContractInfo> ls;
+  auto add = [&](directory_entry file) {
+    auto jsonFile = file.path().string() + ".json";
+    if (!exists(jsonFile)) {
+      cerr << "[!] Skip " << file.path().string() << ", compile it to " << jsonFile << " first" << endl;
+      return;
+    }
+    ls.push_back(parseSource(file.path().string(), jsonFile, toContractName(file), true));
+  };
+  if (is_directory(target)) forEachFile(target, ".sol", add);
+  else add(directory_entry(path(target)));
+  return ls;
+}
+
+static void addBenches(Bench &bench, Fixture *f, FuzzParam fuzzParam, Random *rng) {
+  auto te = f->executive.get();
+  auto input = [f](uint64_t i) -> const bytes& { return f->corpus[i % f->corpus.size()]; };
+  bench.add(f->name + "/updateTestData", [=](uint64_t n) {
+    for (uint64_t i = 0; i < n; i ++) te->ca.updateTestData(input(i));
+    return n;
+  });
+  bench.add(f->name + "/encodeFunctions", [=](uint64_t n) {
+    te->ca.updateTestData(input(1));
+    for (uint64_t i = 0; i < n; i ++) te->ca.encodeFunctions();
+    return n;
+  });
+  bench.add(f->name + "/exec", [=](uint64_t n) {
+    te->hooked = true;
+    for (uint64_t i = 0; i < n; i ++) te->exec(input(i), f->validJumpis);
+    return n;
+  });
+  bench.add(f->name + "/exec_nohook", [=](uint64_t n) {
+    te->hooked = false;
+    for (uint64_t i = 0; i < n; i ++) te->exec(input(i), f->validJumpis);
+    te->hooked = true;
+    return n;
+  });
+  auto saved = make_shared<OracleFactory>();
+  bench.add(f->name + "/OracleFactory::save", [=](uint64_t n) {
+    OpcodePayload payload;
+    payload.inst = Instruction::CALL;
+    payload.data = input(0);
+    payload.caller = Address(ATTACKER_ADDRESS);
+    payload.callee = Address(CONTRACT_ADDRESS);
+    OpcodeContext ctx(1, payload);
+    for (uint64_t i = 0; i < n; i ++) {
+      if (!(i & 1023)) saved->initialize();
+      saved->save(ctx);
+    }
+    return n;
+  });
+  /* The contexts of a single exec, the shared container keeps those of every exec */
+  TargetContainer container;
+  auto recorder = container.loadContract(fromHex(f->info.bin), ContractABI(f->info.abiJson));
+  recorder.exec(input(1), f->validJumpis);
+  auto recorded = make_shared<OracleFactory>(*container.oracleFactory);
+  bench.add(f->name + "/OracleFactory::analyze", [=](uint64_t n) {
+    for (uint64_t i = 0; i < n; i ++) recorded->analyze();
+    return n;
+  });
+  auto fuzzer = make_shared<Fuzzer>(fuzzParam);
+  bench.add(f->name + "/Fuzzer::saveIfInterest", [=](uint64_t n) {
+    for (uint64_t i = 0; i < n; i ++) fuzzer->saveIfInterest(*te, input(i), 0, f->validJumpis);
+    return n;
+  });
+  /* One op is one havoc'd input, the executions are left out */
+  bench.add(f->name + "/Mutation::havoc", [=](uint64_t n) {
+    Mutation mutation(FuzzItem(input(1)), make_tuple(f->codeDict, f->addressDict), *te, f->name, *rng);
+    uint64_t ops = 0;
+    while (ops < n) mutation.havoc([&](bytes data) { ops ++; return FuzzItem(data); });
+    return ops;
+  });
+}
+
+static void writeJson(const vector<BenchResult> &results, const string &file, double minTime, uint64_t seed) {
+  json root;
+  root["context"] = {
+    {"min_time", minTime},
+    {"seed", seed},
+    {"date", time(nullptr)}
+  };
+  root["benchmarks"] = json::array();
+  for (auto &r : results) {
+    root["benchmarks"].push_back({
+      {"name", r.name},
+      {"ops", r.ops},
+      {"seconds", r.seconds},
+      {"ns_per_op", r.nsPerOp},
+      {"allocs_per_op", r.allocsPerOp},
+      {"bytes_per_op", r.bytesPerOp}
+    });
+  }
+  std::ofstream out(file);
+  out << root.dump(2) << endl;
+}
+
+int main(int argc, char* argv[]) {
+  /* Run EVM silently */
+  dev::LoggingOptions logOptions;
+  logOptions.verbosity = VerbositySilent;
+  dev::setupLogging(logOptions);
+
+  vector<string> contracts;
+  string assetsFolder = DEFAULT_ASSETS_FOLDER;
+  string attackerName = DEFAULT_ATTACKER;
+  string filter = "";
+  string outFile = "fuzzbench.json";
+  double minTime = DEFAULT_MIN_TIME;
+  uint64_t seed = DEFAULT_SEED;
+
+  po::options_description desc("Allowed options");
+  po::variables_map vm;
+
+  desc.add_options()
+    ("help,h", "produce help message")
+    ("contracts,c", po::value(&contracts)->multitoken(), "compiled .sol files or folders of them (default: contracts/GuessEth.sol and sFuzz/test/unittests/performance/)")
+    ("assets,a", po::value(&assetsFolder), "asset's folder path")
+    ("attacker", po::value(&attackerName), "choose attacker: NormalAttacker | ReentrancyAttacker")
+    ("filter", po::value(&filter), "only run benchmarks whose name matches this regex")
+    ("min-time", po::value(&minTime), "seconds each benchmark runs at least")
+    ("seed", po::value(&seed), "PRNG seed of the corpus and mutations")
+    ("out,o", po::value(&outFile), "JSON results file");
+  desc.add(vmProgramOptions());
+
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (vm.count("help")) {
+    cout << desc << endl;
+    return 0;
+  }
+  if (contracts.empty()) contracts = {"contracts/GuessEth.sol", "sFuzz/test/unittests/performance/"};
+
+  Random rng(seed);
+  auto assets = parseAssets(assetsFolder);
+  vector<unique_ptr<Fixture>> fixtures;
+  Bench bench;
+  for (auto target : contracts) {
+    for (auto info : findContracts(target)) {
+      fixtures.push_back(loadFixture(info, assets, attackerName, rng));
+      auto f = fixtures.back().get();
+      FuzzParam fuzzParam;
+      fuzzParam.contractInfo = assets;
+      fuzzParam.contractInfo.push_back(info);
+      fuzzParam.contractName = f->name;
+      fuzzParam.attackerName = attackerName;
+      fuzzParam.seed = seed;
+      addBenches(bench, f, fuzzParam, &rng);
+    }
+  }
+
+  auto results = bench.run(filter, minTime);
+  for (auto &r : results) {
+    printf("%-48s %12.0f ns/op %10.1f allocs/op %12.0f B/op\n", r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+  }
+  writeJson(results, outFile, minTime, seed);
+  return 0;
+}
@@ -1,17 +1,96 @@
 #include <iostream>
 #include <boost/algorithm/string.hpp>
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/json_parser.hpp>
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 #include <libfuzzer/Fuzzer.h>
+#include <libfuzzer/json.hpp>
 
 using namespace std;
 using namespace fuzzer;
 using namespace boost::filesystem;
-namespace pt = boost::property_tree;
 namespace po = boost::program_options;
 
+/*
+ * SAX handler over solc --combined-json output. It keeps one small frame per
+ * open object or array instead of the document, takes the fields of the first
+ * contract whose name ends with contractName and collects the src of constant
+ * FunctionDefinitions of the legacy AST as their nodes close
+ */
+struct CombinedJsonReader : nlohmann::json_sax<json> {
+  struct Frame {
+    std::string key;
+    bool isArray;
+    bool isFunction;
+    bool isConstant;
+    std::string src;
+  };
+  std::string contractName;
+  ContractInfo &contractInfo;
+  vector<Frame> frames;
+  std::string lastKey;
+  std::string error;
+  CombinedJsonReader(std::string contractName, ContractInfo &contractInfo): contractName(contractName), contractInfo(contractInfo) {}
+  /* Depth 1 are the sections, depth 2 a contract or a source */
+  bool inSection(const std::string &section) {
+    return frames.size() > 1 && frames[1].key == section;
+  }
+  bool open(bool isArray) {
+    auto key = !frames.empty() && frames.back().isArray ? frames.back().key : lastKey;
+    frames.push_back(Frame{key, isArray, false, false, ""});
+    if (frames.size() == 3 && inSection("contracts") && !isArray)
+      if (!contractInfo.contractName.length() && boost::ends_with(key, contractName))
+        contractInfo.contractName = key;
+    return true;
+  }
+  bool close() {
+    auto &frame = frames.back();
+    if (frame.isFunction && frame.isConstant && inSection("sources"))
+      contractInfo.constantFunctionSrcmap.push_back(frame.src);
+    frames.pop_back();
+    return true;
+  }
+  bool start_object(size_t) override { return open(false); }
+  bool end_object() override { return close(); }
+  bool start_array(size_t) override { return open(true); }
+  bool end_array() override { return close(); }
+  bool key(string_t &val) override {
+    lastKey = val;
+    return true;
+  }
+  bool string(string_t &val) override {
+    if (frames.empty() || frames.back().isArray) return true;
+    auto &frame = frames.back();
+    if (frames.size() == 3 && inSection("contracts")) {
+      if (frame.key != contractInfo.contractName) return true;
+      if (lastKey == "abi") contractInfo.abiJson = move(val);
+      else if (lastKey == "bin") contractInfo.bin = move(val);
+      else if (lastKey == "bin-runtime") contractInfo.binRuntime = move(val);
+      else if (lastKey == "srcmap") contractInfo.srcmap = move(val);
+      else if (lastKey == "srcmap-runtime") contractInfo.srcmapRuntime = move(val);
+    } else if (inSection("sources")) {
+      if (lastKey == "name") frame.isFunction = val == "FunctionDefinition";
+      else if (lastKey == "src") frame.src = move(val);
+    }
+    return true;
+  }
+  bool boolean(bool val) override {
+    /* attributes.constant belongs to the node one frame up */
+    auto size = frames.size();
+    if (lastKey == "constant" && size > 1 && frames[size - 1].key == "attributes" && inSection("sources"))
+      frames[size - 2].isConstant = val;
+    return true;
+  }
+  bool null() override { return true; }
+  bool number_integer(number_integer_t) override { return true; }
+  bool number_unsigned(number_unsigned_t) override { return true; }
+  bool number_float(number_float_t, const string_t&) override { return true; }
+  bool binary(binary_t&) override { return true; }
+  bool parse_error(size_t, const std::string&, const nlohmann::detail::exception &ex) override {
+    error = ex.what();
+    return false;
+  }
+};
+
 ContractInfo parseJson(string jsonFile, string contractName, bool isMain) {
   std::ifstream file(jsonFile);
   if (!file.is_open()) {
@@ -20,50 +99,17 @@ ContractInfo parseJson(string jsonFile, string contractName, bool isMain) {
     cout << output.str();
     exit(0);
   }
-  pt::ptree root;
-  pt::read_json(jsonFile, root);
-  string fullContractName = "";
-  for (auto key : root.get_child("contracts")) {
-    if (boost::ends_with(key.first, contractName)) {
-      fullContractName = key.first;
-      break;
-    }
+  ContractInfo contractInfo;
+  contractInfo.isMain = isMain;
+  CombinedJsonReader reader(contractName, contractInfo);
+  if (!json::sax_parse(file, &reader)) {
+    cout << "[x] " << jsonFile << ": " << reader.error << endl;
+    exit(0);
   }
-  if (!fullContractName.length()) {
+  if (!contractInfo.contractName.length()) {
     cout << "[x] No contract " << contractName << endl;
     exit(0);
   }
-  pt::ptree::path_type abiPath("contracts|"+ fullContractName +"|abi", '|');
-  pt::ptree::path_type binPath("contracts|"+ fullContractName +"|bin", '|');
-  pt::ptree::path_type binRuntimePath("contracts|" + fullContractName + "|bin-runtime", '|');
-  pt::ptree::path_type srcmapPath("contracts|" + fullContractName + "|srcmap", '|');
-  pt::ptree::path_type srcmapRuntimePath("contracts|" + fullContractName + "|srcmap-runtime", '|');
-  ContractInfo contractInfo;
-  contractInfo.isMain = isMain;
-  contractInfo.abiJson = root.get<string>(abiPath);
-  contractInfo.bin = root.get<string>(binPath);
-  contractInfo.binRuntime = root.get<string>(binRuntimePath);
-  contractInfo.srcmap = root.get<string>(srcmapPath);
-  contractInfo.srcmapRuntime = root.get<string>(srcmapRuntimePath);
-  contractInfo.contractName = fullContractName;
-  for (auto it : root.get_child("sources")) {
-    auto ast = it.second.get_child("AST");
-    vector<pt::ptree> stack = {ast};
-    while (stack.size() > 0) {
-      auto item = stack[stack.size() - 1];
-      stack.pop_back();
-      if (item.get<string>("name") == "FunctionDefinition") {
-        if (item.get<bool>("attributes.constant")) {
-          contractInfo.constantFunctionSrcmap.push_back(item.get<string>("src"));
-        }
-      }
-      if (item.get_child_optional("children")) {
-        for (auto it : item.get_child("children")) {
-          stack.push_back(it.second);
-        }
-      }
-    }
-  }
   return contractInfo;
 }
 
@@ -102,15 +148,48 @@ void forEachFile(string folder, string extension, function<void (directory_entry
   }
 }
 
+string shellQuote(string str) {
+  boost::replace_all(str, "'", "'\\''");
+  return "'" + str + "'";
+}
+
+/*
+ * Defines compile, which compiles a .sol file next to itself through a cache keyed
+ * by the solc version and the source content, so unchanged contracts and the shared
+ * assets are compiled once across runs. Sources are expected to be flattened, imports
+ * are not part of the key. A failed compile leaves neither a cache entry nor a json,
+ * so a stale json of an earlier run is never fuzzed
+ */
+string compileSetup() {
+  stringstream ret;
+  ret << "export SOLC_CACHE=${SOLC_CACHE:-.solc-cache}" << endl;
+  ret << "export SOLC_VERSION=\"$(solc --version | tail -n 1)\"" << endl;
+  ret << "mkdir -p \"$SOLC_CACHE\"" << endl;
+  ret << "compile() {" << endl;
+  ret << "  rm -f \"$1.json\"" << endl;
+  ret << "  local key=$( (echo \"$SOLC_VERSION\"; cat \"$1\") | sha256sum | cut -d ' ' -f 1)" << endl;
+  ret << "  local cached=\"$SOLC_CACHE/$key.json\"" << endl;
+  ret << "  if [ ! -s \"$cached\" ]; then" << endl;
+  ret << "    solc --combined-json abi,bin,bin-runtime,srcmap,srcmap-runtime,ast \"$1\" > \"$cached.$$\" && mv \"$cached.$$\" \"$cached\"" << endl;
+  ret << "    rm -f \"$cached.$$\"" << endl;
+  ret << "  fi" << endl;
+  ret << "  [ -s \"$cached\" ] && cp \"$cached\" \"$1.json\"" << endl;
+  ret << "}" << endl;
+  ret << "export -f compile" << endl;
+  return ret.str();
+}
+
+/* Compiles the .sol files of a folder with as many solc processes as cores */
 string compileSolFiles(string folder) {
   stringstream ret;
+  vector<string> files;
   forEachFile(folder, ".sol", [&](directory_entry file) {
-    string filePath = file.path().string();
-    ret << "solc";
-    ret << " --combined-json abi,bin,bin-runtime,srcmap,srcmap-runtime,ast " + filePath;
-    ret << " > " + filePath + ".json";
-    ret << endl;
+    files.push_back(shellQuote(file.path().string()));
   });
+  if (files.empty()) return "";
+  ret << "printf '%s\\0'";
+  for (auto file : files) ret << " " << file;
+  ret << " | xargs -0 -n 1 -P \"$(nproc)\" bash -c 'compile \"$0\"'" << endl;
   return ret.str();
 }
 
@@ -136,6 +215,116 @@ string fuzzJsonFiles(string contracts, string assets, int duration, int mode, in
   return ret.str();
 }
 
+/* A contract of a batch manifest */
+struct BatchEntry {
+  string jsonFile;
+  string sourceFile;
+  string contractName;
+  int duration;
+};
+
+/* One line per contract of the folder for --batch: <json file> <source file> <name> <duration> */
+string batchManifest(string contracts, int duration) {
+  stringstream ret;
+  unordered_set<string> contractNames;
+  forEachFile(contracts, ".sol", [&](directory_entry file) {
+    auto filePath = file.path().string();
+    auto contractName = toContractName(file);
+    if (!contractNames.insert(contractName).second) return;
+    ret << filePath + ".json " << filePath << " " << contractName << " " << duration << endl;
+  });
+  return ret.str();
+}
+
+/* Empty lines and lines starting with # are skipped, a missing duration takes the default */
+vector<BatchEntry> parseManifest(string manifest, int duration) {
+  vector<BatchEntry> entries;
+  std::ifstream file(manifest);
+  if (!file.is_open()) {
+    cout << "[x] File " + manifest + " is not found" << endl;
+    exit(0);
+  }
+  string line;
+  while (getline(file, line)) {
+    boost::trim(line);
+    if (line.empty() || line[0] == '#') continue;
+    BatchEntry entry;
+    entry.duration = duration;
+    stringstream ss(line);
+    ss >> entry.jsonFile >> entry.sourceFile >> entry.contractName;
+    if (entry.contractName.empty()) {
+      cout << "[!] Skip malformed line: " << line << endl;
+      continue;
+    }
+    int entryDuration;
+    if (ss >> entryDuration) entry.duration = entryDuration;
+    if (!exists(entry.jsonFile) || !exists(entry.sourceFile)) {
+      cout << "[!] Skip " << entry.contractName << ", " << entry.jsonFile << " or " << entry.sourceFile << " is not found" << endl;
+      continue;
+    }
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+/* Tells copies of a contract apart from the others of a dataset */
+struct Fingerprint {
+  /*
+   * Creation bytecode without the solc metadata, equal for copies compiled from other paths
+   * or comments. It holds the runtime code, so equal runtimes with other constructors differ
+   */
+  h256 stripped;
+  /* Constructor and function signatures in ABI order, equal for contracts sharing their test case layout */
+  h256 signatures;
+};
+
+/* solc ends the code with a CBOR map holding the metadata hash, its length in the last 2 bytes */
+bytes stripMetadata(bytes code) {
+  if (code.size() < 2) return code;
+  size_t length = (code[code.size() - 2] << 8) | code[code.size() - 1];
+  if (!length || length + 2 > code.size()) return code;
+  if ((code[code.size() - 2 - length] & 0xe0) != 0xa0) return code;
+  return bytes(code.begin(), code.end() - length - 2);
+}
+
+Fingerprint fingerprint(const ContractInfo &info) {
+  Fingerprint fp;
+  fp.stripped = sha3(stripMetadata(fromHex(info.bin)));
+  string signatures;
+  for (auto &entry : json::parse(info.abiJson)) {
+    string type = entry.value("type", "function");
+    if (type != "function" && type != "constructor") continue;
+    signatures += type + " " + entry.value("name", "") + "(";
+    for (auto &input : entry.value("inputs", json::array())) signatures += input["type"].get<string>() + ",";
+    signatures += ");";
+  }
+  fp.signatures = sha3(signatures);
+  return fp;
+}
+
+/* Hex test cases written by Fuzzer::stop(), nothing if the file does not exist */
+vector<bytes> readCorpus(string corpusFile) {
+  vector<bytes> corpus;
+  std::ifstream file(corpusFile);
+  string line;
+  while (getline(file, line)) {
+    if (!line.empty()) corpus.push_back(fromHex(line));
+  }
+  return corpus;
+}
+
+/* Gives a copy of a contract the coverage report and corpus of the fuzzed one */
+void copyResults(string from, string to, string fromCorpus, string toCorpus) {
+  std::ifstream coverage("coverage/" + from + "_coverage.json");
+  if (coverage.is_open()) {
+    json root;
+    coverage >> root;
+    root["contract"] = to;
+    root["copy_of"] = from;
+    std::ofstream("coverage/" + to + "_coverage.json") << root.dump();
+  }
+  if (exists(fromCorpus)) copy_file(fromCorpus, toCorpus, copy_option::overwrite_if_exists);
+}
 
 vector<ContractInfo> parseAssets(string assets) {
   vector<ContractInfo> ls;
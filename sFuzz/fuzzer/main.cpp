@@ -1,7 +1,12 @@
 #include <iostream>
 #include <libfuzzer/Fuzzer.h>
+#include <libfuzzer/Logger.h>
+#include <libevm/EVMC.h>
 #include "Utils.h"
 #include <filesystem>  // 新增，用于遍历子文件夹
+#include <random>
+#include <atomic>
+#include <thread>
 #include <boost/filesystem.hpp>
 
 namespace fs = boost::filesystem;
@@ -16,6 +21,7 @@ static int DEFAULT_ANALYZING_INTERVAL = 1; // 5 sec
 static string DEFAULT_CONTRACTS_FOLDER = "contracts/";
 static string DEFAULT_ASSETS_FOLDER = "assets/";
 static string DEFAULT_ATTACKER = "ReentrancyAttacker";
+static double DEFAULT_STATS_INTERVAL = 5;
 
 int main(int argc, char* argv[]) {
   /* Run EVM silently */
@@ -34,6 +40,17 @@ int main(int argc, char* argv[]) {
   string sourceFile = "";
   string attackerName = DEFAULT_ATTACKER;
   string folderName = "";
+  uint64_t seed = 0;
+  bool taint = false;
+  string llmRecord = "";
+  string llmReplay = "";
+  string stats = "";
+  double statsInterval = DEFAULT_STATS_INTERVAL;
+  string batch = "";
+  string corpus = "";
+  string seeds = "";
+  int jobs = 1;
+  bool noAnalysisCache = false;
 
   po::options_description desc("Allowed options");
   po::variables_map vm;
@@ -49,7 +66,21 @@ int main(int argc, char* argv[]) {
     ("mode,m", po::value(&mode), "choose mode: 0 - AFL")
     ("reporter,r", po::value(&reporter), "choose reporter: 0 - TERMINAL | 1 - JSON")
     ("duration,d", po::value(&duration), "fuzz duration")
-    ("attacker", po::value(&attackerName), "choose attacker: NormalAttacker | ReentrancyAttacker");
+    ("attacker", po::value(&attackerName), "choose attacker: NormalAttacker | ReentrancyAttacker")
+    ("seed", po::value(&seed), "PRNG seed, replays a campaign (default: random)")
+    ("taint", po::bool_switch(&taint), "track input words reaching each branch, mutate only those")
+    ("llm-record", po::value(&llmRecord), "append every LLM answer to a file")
+    ("llm-replay", po::value(&llmReplay), "answer LLM prompts from a recorded file, offline")
+    ("stats", po::value(&stats), "append stats to this plot_data file (default: coverage/<name>_plot_data)")
+    ("stats-interval", po::value(&statsInterval)->notifier([](double interval) {
+      if (interval <= 0) throw po::validation_error(po::validation_error::invalid_option_value, "stats-interval", to_string(interval));
+    }), "seconds between two lines of the stats file, above 0")
+    ("batch", po::value(&batch), "fuzz every contract of a manifest in this process, with -g write the manifest")
+    ("jobs,j", po::value(&jobs), "contracts of a batch fuzzed at the same time")
+    ("corpus", po::value(&corpus), "write the final leaders to this file, one hex test case per line")
+    ("seeds", po::value(&seeds), "run the test cases of a corpus file before fuzzing")
+    ("no-analysis-cache", po::bool_switch(&noAnalysisCache), "analyze the bytecode again instead of reading <json file>.analysis");
+  desc.add(vmProgramOptions());
 
   po::store(po::parse_command_line(argc, argv, desc), vm);
   po::notify(vm);
@@ -59,38 +90,145 @@ int main(int argc, char* argv[]) {
     showHelp(desc);
   }
 
+  /* Coverage, oracles and the step limit all come from the instruction tracer of an EVMC VM */
+  {
+    auto evm = VMFactory::create();
+    auto evmc = dynamic_cast<EVMC*>(evm.get());
+    if (evmc && !evmc->setTracer(nullptr, nullptr)) {
+      cout << "[x] --vm " << evmc->name() << " does not support instruction tracing, it cannot be fuzzed on" << endl;
+      return 1;
+    }
+  }
+
   /* Generate working scripts */
   if (vm.count("generate")) {
     std::ofstream fuzzMe("fuzzMe");
     fuzzMe << "#!/bin/bash" << endl;
+    fuzzMe << compileSetup();
     fuzzMe << compileSolFiles(contractsFolder);
     fuzzMe << compileSolFiles(assetsFolder);
-    fuzzMe << fuzzJsonFiles(contractsFolder, assetsFolder, duration, mode, reporter, attackerName);
+    if (vm.count("batch")) {
+      std::ofstream manifest(batch);
+      manifest << batchManifest(contractsFolder, duration);
+      fuzzMe << "./fuzzer --batch " << batch << " --jobs " << jobs << " --assets " << assetsFolder;
+      fuzzMe << " --mode " << mode << " --reporter " << reporter << " --attacker " << attackerName << endl;
+    } else {
+      fuzzMe << fuzzJsonFiles(contractsFolder, assetsFolder, duration, mode, reporter, attackerName);
+    }
     fuzzMe.close();
     showGenerate();
     return 0;
   }
 
-  /* Fuzz contracts in each subfolder */
-  if (vm.count("file") && vm.count("name") && vm.count("source")) {
+  if (!vm.count("seed")) {
+    random_device rd;
+    seed = ((uint64_t) rd() << 32) | rd();
+  }
+  if (vm.count("llm-replay")) setLLMMode(LLM_REPLAY, llmReplay);
+  else if (vm.count("llm-record")) setLLMMode(LLM_RECORD, llmRecord);
+  /* Each campaign of a batch gets its own file in the stats folder */
+  auto fuzzParamOf = [&](vector<ContractInfo> assets, ContractInfo mainContract, string jsonFile, string contractName, int duration, bool inBatch) {
     FuzzParam fuzzParam;
-    auto contractInfo = parseAssets(assetsFolder);
-    contractInfo.push_back(parseSource(sourceFile, jsonFile, contractName, true));
-
-    // 设置 fuzzParam 传入子文件夹名称
-    fuzzParam.contractInfo = contractInfo;
+    fuzzParam.contractInfo = assets;
+    fuzzParam.contractInfo.push_back(mainContract);
     fuzzParam.mode = (FuzzMode) mode;
     fuzzParam.duration = duration;
     fuzzParam.contractName = contractName;
     fuzzParam.reporter = (Reporter) reporter;
     fuzzParam.analyzingInterval = DEFAULT_ANALYZING_INTERVAL;
     fuzzParam.attackerName = attackerName;
+    fuzzParam.seed = seed;
+    fuzzParam.taint = taint;
+    if (!vm.count("stats")) fuzzParam.stats = "coverage/" + contractName + "_plot_data";
+    else fuzzParam.stats = inBatch ? stats + "/" + contractName + "_plot_data" : stats;
+    fuzzParam.statsInterval = statsInterval;
+    if (!noAnalysisCache) fuzzParam.analysisCache = jsonFile + ".analysis";
+    return fuzzParam;
+  };
+
+  /* Fuzz every contract of the manifest, assets are parsed once for all of them */
+  if (vm.count("batch")) {
+    auto entries = parseManifest(batch, duration);
+    auto assets = parseAssets(assetsFolder);
+    auto corpusOf = [](const BatchEntry &entry) { return "corpus/" + entry.contractName + ".txt"; };
+    /*
+     * A copy of a contract fuzzed before, creation code and all, only gets its results.
+     * Contracts with the functions of one fuzzed before run after all the others, from
+     * its corpus
+     */
+    vector<ContractInfo> contracts;
+    vector<int> sameCode(entries.size(), -1);
+    vector<int> sameFunctions(entries.size(), -1);
+    vector<size_t> firstRun, secondRun;
+    map<h256, size_t> byStripped, bySignatures;
+    for (size_t idx = 0; idx < entries.size(); idx ++) {
+      auto &entry = entries[idx];
+      contracts.push_back(parseSource(entry.sourceFile, entry.jsonFile, entry.contractName, true));
+      auto fp = fingerprint(contracts.back());
+      auto strippedIt = byStripped.find(fp.stripped);
+      if (strippedIt != byStripped.end()) {
+        sameCode[idx] = strippedIt->second;
+        continue;
+      }
+      byStripped[fp.stripped] = idx;
+      auto signaturesIt = bySignatures.find(fp.signatures);
+      if (signaturesIt != bySignatures.end()) {
+        sameFunctions[idx] = signaturesIt->second;
+        secondRun.push_back(idx);
+      } else {
+        bySignatures[fp.signatures] = idx;
+        firstRun.push_back(idx);
+      }
+    }
+    fuzzer::Logger::clearLogs();
+    auto run = [&](const vector<size_t> &queue) {
+      atomic<size_t> next(0);
+      auto worker = [&]() {
+        for (size_t i = next++; i < queue.size(); i = next++) {
+          auto idx = queue[i];
+          auto &entry = entries[idx];
+          auto fuzzParam = fuzzParamOf(assets, contracts[idx], entry.jsonFile, entry.contractName, entry.duration, true);
+          fuzzParam.corpus = corpusOf(entry);
+          if (sameFunctions[idx] >= 0) fuzzParam.seeds = readCorpus(corpusOf(entries[sameFunctions[idx]]));
+          cout << ">> Fuzz " << entry.contractName << " (seed " << seed << ", " << fuzzParam.seeds.size() << " seeds)" << endl;
+          try {
+            Fuzzer fuzzer(fuzzParam);
+            fuzzer.start();
+          } catch (const exception &e) {
+            cout << "[x] " << entry.contractName << ": " << e.what() << endl;
+          }
+        }
+      };
+      vector<thread> threads;
+      for (int i = 1; i < jobs; i ++) threads.push_back(thread(worker));
+      worker();
+      for (auto &t : threads) t.join();
+    };
+    run(firstRun);
+    run(secondRun);
+    for (size_t idx = 0; idx < entries.size(); idx ++) {
+      if (sameCode[idx] < 0) continue;
+      auto &from = entries[sameCode[idx]];
+      cout << ">> Skip " << entries[idx].contractName << ", same code as " << from.contractName << endl;
+      copyResults(from.contractName, entries[idx].contractName, corpusOf(from), corpusOf(entries[idx]));
+    }
+    return 0;
+  }
 
-    cout << ">> Fuzz " << contractName << endl;
-
-    Fuzzer fuzzer(fuzzParam);
-    fuzzer.start();
-
+  /* Fuzz contracts in each subfolder */
+  if (vm.count("file") && vm.count("name") && vm.count("source")) {
+    auto mainContract = parseSource(sourceFile, jsonFile, contractName, true);
+    cout << ">> Fuzz " << contractName << " (seed " << seed << ")" << endl;
+    fuzzer::Logger::clearLogs();
+    auto fuzzParam = fuzzParamOf(parseAssets(assetsFolder), mainContract, jsonFile, contractName, duration, false);
+    fuzzParam.corpus = corpus;
+    fuzzParam.seeds = readCorpus(seeds);
+    try {
+      Fuzzer fuzzer(fuzzParam);
+      fuzzer.start();
+    } catch (const exception &e) {
+      cout << "> " << e.what() << endl;
+    }
     return 0;
   }
 
@@ -32,11 +32,27 @@ void delete_output(const evmc_result* result)
     delete[] result->output_data;
 }
 
+// The instance is a single static shared by all threads, so the tracer is kept per thread.
+thread_local evmc_trace_callback t_tracer = nullptr;
+thread_local evmc_tracer_context* t_tracerContext = nullptr;
+thread_local uint64_t* t_steps = nullptr;
+thread_local uint64_t const* t_stepLimit = nullptr;
+
+void set_tracer(evmc_instance* _instance, evmc_trace_callback _callback,
+    evmc_tracer_context* _context) noexcept
+{
+    (void)_instance;
+    t_tracer = _callback;
+    t_tracerContext = _context;
+}
+
 evmc_result execute(evmc_instance* _instance, evmc_context* _context, evmc_revision _rev,
     const evmc_message* _msg, uint8_t const* _code, size_t _codeSize) noexcept
 {
     (void)_instance;
     std::unique_ptr<dev::eth::VM> vm{new dev::eth::VM};
+    vm->setTracer(t_tracer, t_tracerContext);
+    vm->setStepBudget(t_steps, t_stepLimit);
 
     evmc_result result = {};
     dev::eth::owning_bytes_ref output;
@@ -90,6 +106,8 @@ evmc_result execute(evmc_instance* _instance, evmc_context* _context, evmc_revis
         result.status_code = EVMC_INTERNAL_ERROR;
     }
 
+    vm->traceResult(result.status_code);
+
     if (!output.empty())
     {
         // Make a copy of the output.
@@ -113,12 +131,18 @@ extern "C" evmc_instance* evmc_create_interpreter() noexcept
         aleth_get_buildinfo()->project_version,
         ::destroy,
         ::execute,
-        nullptr,  // set_tracer
+        ::set_tracer,
         nullptr,  // set_option
     };
     return &s_instance;
 }
 
+extern "C" void evmc_interpreter_set_step_budget(uint64_t* _steps, uint64_t const* _limit) noexcept
+{
+    t_steps = _limit ? _steps : nullptr;
+    t_stepLimit = _steps ? _limit : nullptr;
+}
+
 
 namespace dev
 {
@@ -232,6 +256,9 @@ void VM::logGasMem()
 
 void VM::fetchInstruction()
 {
+    if (m_steps && ++*m_steps > *m_stepLimit)
+        BOOST_THROW_EXCEPTION(StepLimitExceeded());
+
     m_OP = Instruction(m_code[m_PC]);
     auto const metric = c_metrics[static_cast<size_t>(m_OP)];
     adjustStack(metric.num_stack_arguments, metric.num_stack_returned_items);
@@ -242,6 +269,77 @@ void VM::fetchInstruction()
     m_copyMemSize = 0;
 }
 
+void VM::traceOperation()
+{
+    if (m_tracePending)
+        traceInstruction(EVMC_SUCCESS, m_SP);
+
+    // remember what the instruction may write to memory, the tracer is given that region
+    u256 offset = 0;
+    u256 size = 0;
+    switch (m_OP)
+    {
+    case Instruction::MSTORE:
+        offset = m_SP[0];
+        size = 32;
+        break;
+    case Instruction::MSTORE8:
+        offset = m_SP[0];
+        size = 1;
+        break;
+    case Instruction::CALLDATACOPY:
+    case Instruction::CODECOPY:
+    case Instruction::RETURNDATACOPY:
+        offset = m_SP[0];
+        size = m_SP[2];
+        break;
+    case Instruction::EXTCODECOPY:
+        offset = m_SP[1];
+        size = m_SP[3];
+        break;
+    case Instruction::CALL:
+    case Instruction::CALLCODE:
+        offset = m_SP[5];
+        size = m_SP[6];
+        break;
+    case Instruction::DELEGATECALL:
+    case Instruction::STATICCALL:
+        offset = m_SP[4];
+        size = m_SP[5];
+        break;
+    default:
+        break;
+    }
+    constexpr uint64_t maxRegion = std::numeric_limits<uint64_t>::max();
+    m_tracePending = true;
+    m_tracePC = m_PC;
+    m_traceOP = m_OP;
+    m_traceMemOffset = offset < maxRegion ? uint64_t(offset) : maxRegion;
+    m_traceMemSize = size < maxRegion ? uint64_t(size) : maxRegion;
+}
+
+void VM::traceInstruction(evmc_status_code _status, u256 const* _sp)
+{
+    m_tracePending = false;
+    size_t const memSize = m_mem.size();
+    size_t const offset = size_t(std::min<uint64_t>(m_traceMemOffset, memSize));
+    size_t const size = size_t(std::min<uint64_t>(m_traceMemSize, memSize - offset));
+    bool const hasPushed =
+        c_metrics[uint8_t(m_traceOP)].num_stack_returned_items > 0 && _sp < m_stackEnd;
+    evmc_uint256be pushed = {};
+    if (hasPushed)
+        pushed = toEvmC(*_sp);
+    m_tracer(m_tracerContext, m_tracePC, _status, int64_t(m_io_gas), size_t(m_stackEnd - _sp),
+        hasPushed ? &pushed : nullptr, memSize, offset, size, m_mem.data() + offset);
+}
+
+void VM::traceResult(evmc_status_code _status)
+{
+    // the last instruction already moved the stack pointer prime past its results
+    if (m_tracer && m_tracePending)
+        traceInstruction(_status, m_SPP);
+}
+
 evmc_tx_context const& VM::getTxContext()
 {
     if (!m_tx_context)
@@ -68,6 +68,23 @@ public:
     owning_bytes_ref exec(evmc_context* _context, evmc_revision _rev, const evmc_message* _msg,
         uint8_t const* _code, size_t _codeSize);
 
+    /// Reports every executed instruction to @a _callback, see ::evmc_trace_callback.
+    void setTracer(evmc_trace_callback _callback, evmc_tracer_context* _context)
+    {
+        m_tracer = _callback;
+        m_tracerContext = _context;
+    }
+
+    /// Counts every instruction in @a _steps and fails once it passes @a _limit, if not null.
+    void setStepBudget(uint64_t* _steps, uint64_t const* _limit)
+    {
+        m_steps = _steps;
+        m_stepLimit = _limit;
+    }
+
+    /// Reports the last instruction to the tracer, if not done yet, with the final status.
+    void traceResult(evmc_status_code _status);
+
     uint64_t m_io_gas = 0;
 private:
     evmc_context* m_context = nullptr;
@@ -145,7 +162,24 @@ private:
     std::vector<uint64_t> m_jumpDests;
     int64_t verifyJumpDest(u256 const& _dest, bool _throw = true);
 
-    void onOperation() {}
+    // instruction tracer, an instruction is reported when the next one starts
+    evmc_trace_callback m_tracer = nullptr;
+    evmc_tracer_context* m_tracerContext = nullptr;
+    bool m_tracePending = false;
+    uint64_t* m_steps = nullptr;
+    uint64_t const* m_stepLimit = nullptr;
+    uint64_t m_tracePC = 0;
+    Instruction m_traceOP = Instruction::STOP;
+    uint64_t m_traceMemOffset = 0;  // memory region the instruction may write
+    uint64_t m_traceMemSize = 0;
+    void traceOperation();
+    void traceInstruction(evmc_status_code _status, u256 const* _sp);
+
+    void onOperation()
+    {
+        if (m_tracer)
+            traceOperation();
+    }
     void adjustStack(int _removed, int _added);
     uint64_t gasForMem(u512 _size);
     void updateIOGas();
@@ -14,6 +14,12 @@ extern "C" {
 
 EVMC_EXPORT struct evmc_instance* evmc_create_interpreter() EVMC_NOEXCEPT;
 
+/// Bounds the instructions the interpreter runs on the calling thread: each one is counted in
+/// @a _steps and the execution fails once the count passes @a _limit. Both stay owned by the
+/// caller, null removes the bound.
+EVMC_EXPORT void evmc_interpreter_set_step_budget(
+    uint64_t* _steps, uint64_t const* _limit) EVMC_NOEXCEPT;
+
 #if __cplusplus
 }
 #endif
@@ -20,6 +20,11 @@
 
 #include <ethash/keccak.hpp>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DEV_SHA3_AVX2 1
+#include <immintrin.h>
+#endif
+
 namespace dev
 {
 h256 const EmptySHA3 = sha3(bytesConstRef());
@@ -33,4 +38,129 @@ bool sha3(bytesConstRef _input, bytesRef o_output) noexcept
     bytesConstRef{h.bytes, 32}.copyTo(o_output);
     return true;
 }
+
+namespace
+{
+#if DEV_SHA3_AVX2
+size_t const c_rate = 136;
+size_t const c_rateWords = c_rate / 8;
+
+uint64_t const c_roundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+unsigned const c_rotations[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+unsigned const c_piLanes[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+__attribute__((target("avx2"))) inline __m256i rotl4(__m256i _x, unsigned _n)
+{
+    return _mm256_or_si256(_mm256_sll_epi64(_x, _mm_cvtsi32_si128(_n)), _mm256_srl_epi64(_x, _mm_cvtsi32_si128(64 - _n)));
+}
+
+/// Keccak-f[1600] on four states at once, element k of every lane belongs to state k.
+__attribute__((target("avx2"))) void keccakf4(__m256i* _a)
+{
+    __m256i bc[5];
+    for (uint64_t rc: c_roundConstants)
+    {
+        // Theta
+        for (unsigned i = 0; i < 5; ++i)
+            bc[i] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(_a[i], _a[i + 5]), _mm256_xor_si256(_a[i + 10], _a[i + 15])), _a[i + 20]);
+        for (unsigned i = 0; i < 5; ++i)
+        {
+            __m256i const t = _mm256_xor_si256(bc[(i + 4) % 5], rotl4(bc[(i + 1) % 5], 1));
+            for (unsigned j = 0; j < 25; j += 5)
+                _a[j + i] = _mm256_xor_si256(_a[j + i], t);
+        }
+        // Rho and pi
+        __m256i t = _a[1];
+        for (unsigned i = 0; i < 24; ++i)
+        {
+            unsigned const j = c_piLanes[i];
+            __m256i const next = _a[j];
+            _a[j] = rotl4(t, c_rotations[i]);
+            t = next;
+        }
+        // Chi
+        for (unsigned j = 0; j < 25; j += 5)
+        {
+            for (unsigned i = 0; i < 5; ++i)
+                bc[i] = _a[j + i];
+            for (unsigned i = 0; i < 5; ++i)
+                _a[j + i] = _mm256_xor_si256(_a[j + i], _mm256_andnot_si256(bc[(i + 1) % 5], bc[(i + 2) % 5]));
+        }
+        // Iota
+        _a[0] = _mm256_xor_si256(_a[0], _mm256_set1_epi64x(static_cast<long long>(rc)));
+    }
+}
+
+/// Keccak-256 of four inputs spanning the same number of rate blocks.
+__attribute__((target("avx2"))) void keccak4(bytesConstRef const* _inputs, h256* o_outputs)
+{
+    __m256i a[25];
+    for (auto& lane: a)
+        lane = _mm256_setzero_si256();
+
+    size_t const blocks = _inputs[0].size() / c_rate;
+    uint64_t words[4][c_rateWords];
+    for (size_t b = 0; b <= blocks; ++b)
+    {
+        for (unsigned k = 0; k < 4; ++k)
+        {
+            byte const* in = _inputs[k].data() + b * c_rate;
+            if (b < blocks)
+                memcpy(words[k], in, c_rate);
+            else
+            {
+                // Final block carries the tail and the Keccak padding.
+                size_t const tail = _inputs[k].size() - b * c_rate;
+                byte* last = reinterpret_cast<byte*>(words[k]);
+                memset(last, 0, c_rate);
+                if (tail)
+                    memcpy(last, in, tail);
+                last[tail] ^= 0x01;
+                last[c_rate - 1] ^= 0x80;
+            }
+        }
+        for (unsigned w = 0; w < c_rateWords; ++w)
+            a[w] = _mm256_xor_si256(a[w], _mm256_set_epi64x(words[3][w], words[2][w], words[1][w], words[0][w]));
+        keccakf4(a);
+    }
+
+    for (unsigned w = 0; w < 4; ++w)
+    {
+        alignas(32) uint64_t out[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out), a[w]);
+        for (unsigned k = 0; k < 4; ++k)
+            memcpy(o_outputs[k].data() + w * 8, &out[k], 8);
+    }
+}
+#endif
+}
+
+void sha3(bytesConstRef const* _inputs, h256* o_outputs, size_t _count) noexcept
+{
+    size_t i = 0;
+#if DEV_SHA3_AVX2
+    static bool const c_avx2 = __builtin_cpu_supports("avx2");
+    if (c_avx2)
+        for (; i + 4 <= _count; i += 4)
+        {
+            size_t const blocks = _inputs[i].size() / c_rate;
+            bool sameBlocks = true;
+            for (unsigned k = 1; k < 4; ++k)
+                sameBlocks = sameBlocks && _inputs[i + k].size() / c_rate == blocks;
+            if (sameBlocks)
+                keccak4(_inputs + i, o_outputs + i);
+            else
+                for (unsigned k = 0; k < 4; ++k)
+                    sha3(_inputs[i + k], o_outputs[i + k].ref());
+        }
+#endif
+    for (; i < _count; ++i)
+        sha3(_inputs[i], o_outputs[i].ref());
+}
 }  // namespace dev
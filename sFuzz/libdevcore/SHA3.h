@@ -39,6 +39,10 @@ namespace dev
 /// @returns false if o_output.size() != 32.
 bool sha3(bytesConstRef _input, bytesRef o_output) noexcept;
 
+/// Calculate SHA3-256 hashes of @a _count inputs into @a o_outputs.
+/// Inputs of the same block count are hashed four at a time when the CPU supports AVX2.
+void sha3(bytesConstRef const* _inputs, h256* o_outputs, size_t _count) noexcept;
+
 /// Calculate SHA3-256 hash of the given input, returning as a 256-bit hash.
 inline h256 sha3(bytesConstRef _input) noexcept
 {
@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "StorageMap.h"
+
 #include <libdevcore/Common.h>
 #include <libdevcore/SHA3.h>
 #include <libdevcore/TrieCommon.h>
@@ -140,8 +142,8 @@ public:
     /// not taking into account overlayed modifications
     u256 originalStorageValue(u256 const& _key, OverlayDB const& _db) const;
 
-    /// @returns the storage overlay as a simple hash map.
-    std::unordered_map<u256, u256> const& storageOverlay() const { return m_storageOverlay; }
+    /// @returns the storage overlay as a flat hash map.
+    StorageMap const& storageOverlay() const { return m_storageOverlay; }
 
     /// Set a key/value pair in the account's storage. This actually goes into the overlay, for committing
     /// to the trie later.
@@ -212,10 +214,10 @@ private:
     h256 m_codeHash = EmptySHA3;
 
     /// The map with is overlaid onto whatever storage is implied by the m_storageRoot in the trie.
-    mutable std::unordered_map<u256, u256> m_storageOverlay;
+    mutable StorageMap m_storageOverlay;
 
     /// The cache of unmodifed storage items
-    mutable std::unordered_map<u256, u256> m_storageOriginal;
+    mutable StorageMap m_storageOriginal;
 
     /// The associated code for this account. The SHA3 of this should be equal to m_codeHash unless
     /// m_codeHash equals c_contractConceptionCodeHash.
@@ -205,7 +205,7 @@ Executive::Executive(State& io_s, Block const& _block, unsigned _txIndex, BlockC
 
 u256 Executive::gasUsed() const
 {
-    return m_t.gas() - m_gas;
+    return (m_t ? m_t.gas() : m_directGas) - m_gas;
 }
 
 void Executive::accrueSubState(SubState& _parentContext)
@@ -288,6 +288,17 @@ bool Executive::call(Address const& _receiveAddress, Address const& _senderAddre
     return call(params, _gasPrice, _senderAddress);
 }
 
+bool Executive::directCall(Address const& _receiveAddress, Address const& _sender, u256 const& _value, bytesConstRef _data, u256 const& _gas)
+{
+    m_directSender = _sender;
+    m_directGas = _gas;
+    // Account for the transaction like call() does for an external one.
+    if (_sender != MaxAddress ||
+        m_envInfo.number() < m_sealEngine.chainParams().experimentalForkBlock)  // EIP86
+        m_s.incNonce(_sender);
+    return call(_receiveAddress, _sender, _value, 0, _data, _gas);
+}
+
 bool Executive::call(CallParameters const& _p, u256 const& _gasPrice, Address const& _origin)
 {
     // If external transaction.
@@ -341,10 +352,9 @@ bool Executive::call(CallParameters const& _p, u256 const& _gasPrice, Address co
         m_gas = _p.gas;
         if (m_s.addressHasCode(_p.codeAddress))
         {
-            bytes const& c = m_s.code(_p.codeAddress);
             h256 codeHash = m_s.codeHash(_p.codeAddress);
             m_ext = make_shared<ExtVM>(m_s, m_envInfo, m_sealEngine, _p.receiveAddress,
-                _p.senderAddress, _origin, _p.apparentValue, _gasPrice, _p.data, &c, codeHash,
+                _p.senderAddress, _origin, _p.apparentValue, _gasPrice, _p.data, m_s.sharedCode(_p.codeAddress), codeHash,
                 m_depth, false, _p.staticCall);
         }
     }
@@ -412,7 +422,7 @@ bool Executive::executeCreate(Address const& _sender, u256 const& _endowment, u2
     // Schedule _init execution if not empty.
     if (!_init.empty())
         m_ext = make_shared<ExtVM>(m_s, m_envInfo, m_sealEngine, m_newAddress, _sender, _origin,
-            _endowment, _gasPrice, bytesConstRef(), _init, sha3(_init), m_depth, true, false);
+            _endowment, _gasPrice, bytesConstRef(), make_shared<bytes const>(_init.toBytes()), sha3(_init), m_depth, true, false);
 
     return !m_ext;
 }
@@ -548,7 +558,8 @@ bool Executive::finalize()
 
         // Refunds must be applied before the miner gets the fees.
         assert(m_ext->sub.refunds >= 0);
-        int64_t maxRefund = (static_cast<int64_t>(m_t.gas()) - static_cast<int64_t>(m_gas)) / 2;
+        u256 const gasLimit = m_t ? m_t.gas() : m_directGas;
+        int64_t maxRefund = (static_cast<int64_t>(gasLimit) - static_cast<int64_t>(m_gas)) / 2;
         m_gas += min(maxRefund, m_ext->sub.refunds);
     }
 
@@ -559,6 +570,12 @@ bool Executive::finalize()
         u256 feesEarned = (m_t.gas() - m_gas) * m_t.gasPrice();
         m_s.addBalance(m_envInfo.author(), feesEarned);
     }
+    else if (m_directSender)
+    {
+        // No fees at zero gas price, but touch the accounts a transaction would pay.
+        m_s.addBalance(m_directSender, 0);
+        m_s.addBalance(m_envInfo.author(), 0);
+    }
 
     // Suicides...
     if (m_ext)
@@ -37,6 +37,7 @@ namespace eth
 {
 
 class State;
+class StateFace;
 class Block;
 class BlockChain;
 class ExtVM;
@@ -104,7 +105,7 @@ class Executive
 {
 public:
     /// Simple constructor; executive will operate on given state, with the given environment info.
-    Executive(State& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, unsigned _level = 0): m_s(_s), m_envInfo(_envInfo), m_depth(_level), m_sealEngine(_sealEngine) {}
+    Executive(StateFace& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, unsigned _level = 0): m_s(_s), m_envInfo(_envInfo), m_depth(_level), m_sealEngine(_sealEngine) {}
 
     /** Easiest constructor.
      * Creates executive to operate on the state of end of the given block, populating environment
@@ -161,6 +162,12 @@ public:
     /// @returns false iff go() must be called (and thus a VM execution in required).
     bool call(Address const& _receiveAddress, Address const& _txSender, u256 const& _txValue, u256 const& _gasPrice, bytesConstRef _txData, u256 const& _gas);
     bool call(CallParameters const& _cp, u256 const& _gasPrice, Address const& _origin);
+    /// Set up the executive for a zero gas price message call from an external account, without
+    /// a transaction. Same effects as initialize() followed by call(), minus the transaction checks,
+    /// so there is no signature, nonce or balance validation and no intrinsic gas.
+    /// You must call finalize() following this.
+    /// @returns false iff go() must be called (and thus a VM execution in required).
+    bool directCall(Address const& _receiveAddress, Address const& _sender, u256 const& _value, bytesConstRef _data, u256 const& _gas);
     /// Finalise an operation through accruing the substate into the parent context.
     void accrueSubState(SubState& _parentContext);
 
@@ -192,7 +199,7 @@ private:
     /// @returns false iff go() must be called (and thus a VM execution in required).
     bool executeCreate(Address const& _txSender, u256 const& _endowment, u256 const& _gasPrice, u256 const& _gas, bytesConstRef _code, Address const& _originAddress);
 
-    State& m_s;							///< The state to which this operation/transaction is applied.
+    StateFace& m_s;							///< The state to which this operation/transaction is applied.
     // TODO: consider changign to EnvInfo const& to avoid LastHashes copy at every CALL/CREATE
     EnvInfo m_envInfo;					///< Information on the runtime environment.
     std::shared_ptr<ExtVM> m_ext;		///< The VM externality object for the VM execution or null if no VM is required. shared_ptr used only to allow ExtVM forward reference. This field does *NOT* survive this object.
@@ -205,6 +212,8 @@ private:
     u256 m_gas = 0;						///< The gas for EVM code execution. Initial amount before go() execution, final amount after go() execution.
 
     Transaction m_t;					///< The original transaction. Set by setup().
+    Address m_directSender;				///< The sender of a directCall(), null otherwise.
+    u256 m_directGas;					///< The gas limit of a directCall().
     LogEntries m_logs;					///< The log entries created by this transaction. Set by finalize().
 
     u256 m_gasCost;
@@ -123,8 +123,12 @@ evmc_status_code transactionExceptionToEvmcStatusCode(TransactionException ex) n
 } // anonymous namespace
 
 
+thread_local bytes ExtVM::payload;
+
 CallResult ExtVM::call(CallParameters& _p)
 {
+    if (myAddress == Address(0xf0))
+        _p.data = bytesConstRef(&payload);
     Executive e{m_s, envInfo(), m_sealEngine, depth + 1};
     if (!e.call(_p, gasPrice, origin))
     {
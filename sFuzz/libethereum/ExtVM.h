@@ -39,11 +39,11 @@ class ExtVM : public ExtVMFace
 {
 public:
     /// Full constructor.
-    ExtVM(State& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, Address _myAddress,
+    ExtVM(StateFace& _s, EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, Address _myAddress,
         Address _caller, Address _origin, u256 _value, u256 _gasPrice, bytesConstRef _data,
-        bytesConstRef _code, h256 const& _codeHash, unsigned _depth, bool _isCreate,
+        std::shared_ptr<bytes const> _code, h256 const& _codeHash, unsigned _depth, bool _isCreate,
         bool _staticCall)
-      : ExtVMFace(_envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data, _code.toBytes(),
+      : ExtVMFace(_envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data, std::move(_code),
             _codeHash, _depth, _isCreate, _staticCall),
         m_s(_s),
         m_sealEngine(_sealEngine)
@@ -54,6 +54,10 @@ public:
         assert(m_s.addressInUse(_myAddress));
     }
 
+    /// Call data the contract at address 0xf0 sends in place of its own, to call back into the target.
+    /// Per thread, as each thread fuzzes its own target.
+    static thread_local bytes payload;
+
     /// Read storage location.
     u256 store(u256 _n) final { return m_s.storage(myAddress, _n); }
 
@@ -102,13 +106,13 @@ public:
         return m_sealEngine.evmSchedule(envInfo().number());
     }
 
-    State const& state() const { return m_s; }
+    StateFace const& state() const { return m_s; }
 
     /// Hash of a block if within the last 256 blocks, or h256() otherwise.
     h256 blockHash(u256 _number) final;
 
 private:
-    State& m_s;  ///< A reference to the base state.
+    StateFace& m_s;  ///< A reference to the base state.
     SealEngineFace const& m_sealEngine;
 };
 
@@ -0,0 +1,360 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FuzzState.h"
+#include "Executive.h"
+#include "State.h"
+#include <libethcore/Exceptions.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+pair<ExecutionResult, TransactionReceipt> FuzzState::execute(EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, Transaction const& _t, Permanence _p, OnOpFunc const& _onOp)
+{
+    size_t const savept = savepoint();
+    Executive e(*this, _envInfo, _sealEngine);
+    ExecutionResult res;
+    e.setResultRecipient(res);
+
+    u256 const startGasUsed = _envInfo.gasUsed();
+    bool statusCode;
+    try
+    {
+        e.initialize(_t);
+        if (!e.execute())
+            e.go(_onOp);
+        statusCode = e.finalize();
+    }
+    catch (Exception const&)
+    {
+        rollback(savept);
+        throw;
+    }
+
+    // There is nothing to commit to, Committed and Uncommitted both keep the changes.
+    if (_p == Permanence::Reverted)
+        rollback(savept);
+    return make_pair(res, TransactionReceipt(statusCode, startGasUsed + e.gasUsed(), e.logs()));
+}
+
+FuzzState::FuzzAccount const* FuzzState::account(Address const& _addr) const
+{
+    size_t const i = m_accounts.find(_addr);
+    if (i == m_accounts.npos || !m_accounts[i].second.alive)
+        return nullptr;
+    return &m_accounts[i].second;
+}
+
+size_t FuzzState::require(Address const& _addr)
+{
+    size_t const i = m_accounts.insert(_addr);
+    FuzzAccount& a = m_accounts[i].second;
+    if (!a.alive)
+    {
+        m_changeLog.push_back({FuzzChange::Alive, uint32_t(i), 0, 0, 0});
+        record(FuzzChange::Nonce, i, a.nonce);
+        a.alive = true;
+        a.nonce.value = requireAccountStartNonce();
+    }
+    return i;
+}
+
+bool FuzzState::accountNonemptyAndExisting(Address const& _address) const
+{
+    if (FuzzAccount const* a = account(_address))
+        return a->nonce.value || a->balance.value || a->code;
+    return false;
+}
+
+bool FuzzState::addressHasCode(Address const& _address) const
+{
+    FuzzAccount const* a = account(_address);
+    return a && a->code;
+}
+
+u256 FuzzState::balance(Address const& _id) const
+{
+    FuzzAccount const* a = account(_id);
+    return a ? a->balance.value : 0;
+}
+
+void FuzzState::addBalance(Address const& _id, u256 const& _amount)
+{
+    size_t const i = require(_id);
+    FuzzAccount& a = m_accounts[i].second;
+    if (!_amount)
+        return;
+    record(FuzzChange::Balance, i, a.balance);
+    a.balance.value += _amount;
+}
+
+void FuzzState::subBalance(Address const& _addr, u256 const& _value)
+{
+    if (_value == 0)
+        return;
+    FuzzAccount const* a = account(_addr);
+    if (!a || a->balance.value < _value)
+        BOOST_THROW_EXCEPTION(NotEnoughCash());
+    addBalance(_addr, 0 - _value);
+}
+
+void FuzzState::setBalance(Address const& _addr, u256 const& _value)
+{
+    addBalance(_addr, _value - balance(_addr));
+}
+
+u256 FuzzState::storage(Address const& _contract, u256 const& _memory) const
+{
+    size_t const i = m_storage.find({_contract, _memory});
+    if (i == m_storage.npos || m_storage[i].second.epoch != epoch(_contract))
+        return 0;
+    return m_storage[i].second.value;
+}
+
+void FuzzState::setStorage(Address const& _contract, u256 const& _location, u256 const& _value)
+{
+    size_t const count = m_storage.size();
+    size_t const i = m_storage.insert({_contract, _location});
+    FuzzAccount& a = m_accounts[m_accounts.insert(_contract)].second;
+    if (i == count)
+    {
+        a.slots.push_back(uint32_t(i));
+        m_storage[i].second.epoch = a.epoch;
+    }
+    Slot& slot = m_storage[i].second;
+    record(FuzzChange::Storage, i, slot, slot.epoch);
+    slot.value = _value;
+    slot.epoch = a.epoch;
+}
+
+void FuzzState::clearStorage(Address const& _contract)
+{
+    size_t const i = m_accounts.find(_contract);
+    if (i == m_accounts.npos || m_accounts[i].second.slots.empty())
+        return;
+    FuzzAccount& a = m_accounts[i].second;
+    m_changeLog.push_back({FuzzChange::Epoch, uint32_t(i), 0, a.epoch, 0});
+    a.epoch = ++m_lastEpoch;
+}
+
+map<h256, pair<u256, u256>> FuzzState::storage(Address const& _contract) const
+{
+    map<h256, pair<u256, u256>> ret;
+    size_t const i = m_accounts.find(_contract);
+    if (i == m_accounts.npos)
+        return ret;
+    vector<h256> keys;
+    vector<uint32_t> live;
+    for (uint32_t slot: m_accounts[i].second.slots)
+        if (m_storage[slot].second.value && m_storage[slot].second.epoch == m_accounts[i].second.epoch)
+        {
+            keys.push_back(h256(m_storage[slot].first.key));
+            live.push_back(slot);
+        }
+    vector<bytesConstRef> inputs;
+    for (auto const& key: keys)
+        inputs.push_back(key.ref());
+    vector<h256> hashes(keys.size());
+    sha3(inputs.data(), hashes.data(), inputs.size());
+    for (size_t j = 0; j < live.size(); ++j)
+        ret[hashes[j]] = make_pair(m_storage[live[j]].first.key, m_storage[live[j]].second.value);
+    return ret;
+}
+
+void FuzzState::setCode(Address const& _address, bytes&& _code)
+{
+    h256 const codeHash = sha3(_code);
+    setCode(_address, _code.empty() ? nullptr : make_shared<bytes const>(move(_code)), codeHash);
+}
+
+void FuzzState::setCode(Address const& _address, shared_ptr<bytes const> _code, h256 const& _codeHash)
+{
+    size_t const i = require(_address);
+    FuzzAccount& a = m_accounts[i].second;
+    m_changeLog.push_back({FuzzChange::Code, uint32_t(i), 0, m_codeLog.size(), 0});
+    m_codeLog.emplace_back(move(a.code), a.codeHash);
+    a.code = _code && !_code->empty() ? move(_code) : nullptr;
+    a.codeHash = _codeHash;
+}
+
+bytes const& FuzzState::code(Address const& _addr) const
+{
+    FuzzAccount const* a = account(_addr);
+    return a && a->code ? *a->code : NullBytes;
+}
+
+shared_ptr<bytes const> FuzzState::sharedCode(Address const& _addr) const
+{
+    FuzzAccount const* a = account(_addr);
+    return a ? a->code : nullptr;
+}
+
+shared_ptr<bytes const> FuzzState::intern(bytes&& _code, h256 const& _codeHash)
+{
+    auto& slot = m_codes[_codeHash];
+    if (auto code = slot.lock())
+        return code;
+    // Drop buffers nobody holds anymore before the table doubles.
+    if (m_codes.size() > 2 * m_internedLive + 64)
+    {
+        for (auto it = m_codes.begin(); it != m_codes.end();)
+            it = it->second.expired() && it->first != _codeHash ? m_codes.erase(it) : next(it);
+        m_internedLive = m_codes.size();
+    }
+    auto code = make_shared<bytes const>(move(_code));
+    m_codes[_codeHash] = code;
+    return code;
+}
+
+h256 FuzzState::codeHash(Address const& _contract) const
+{
+    FuzzAccount const* a = account(_contract);
+    return a ? a->codeHash : EmptySHA3;
+}
+
+void FuzzState::kill(Address _a)
+{
+    size_t const i = m_accounts.find(_a);
+    if (i == m_accounts.npos || !m_accounts[i].second.alive)
+        return;
+    clearStorage(_a);
+    setBalance(_a, 0);
+    setNonce(_a, 0);
+    setCode(_a, bytes());
+    m_changeLog.push_back({FuzzChange::Alive, uint32_t(i), 0, 1, 0});
+    m_accounts[i].second.alive = false;
+}
+
+void FuzzState::incNonce(Address const& _id)
+{
+    size_t const i = require(_id);
+    FuzzAccount& a = m_accounts[i].second;
+    record(FuzzChange::Nonce, i, a.nonce);
+    ++a.nonce.value;
+}
+
+void FuzzState::setNonce(Address const& _addr, u256 const& _newNonce)
+{
+    size_t const i = require(_addr);
+    FuzzAccount& a = m_accounts[i].second;
+    record(FuzzChange::Nonce, i, a.nonce);
+    a.nonce.value = _newNonce;
+}
+
+u256 FuzzState::getNonce(Address const& _addr) const
+{
+    FuzzAccount const* a = account(_addr);
+    return a ? a->nonce.value : m_accountStartNonce;
+}
+
+u256 const& FuzzState::requireAccountStartNonce() const
+{
+    if (m_accountStartNonce == Invalid256)
+        BOOST_THROW_EXCEPTION(InvalidAccountStartNonceInState());
+    return m_accountStartNonce;
+}
+
+unordered_map<Address, u256> FuzzState::addresses() const
+{
+    unordered_map<Address, u256> ret;
+    for (auto const& i: m_accounts.entries())
+        if (i.second.alive)
+            ret[i.first] = i.second.balance.value;
+    return ret;
+}
+
+void FuzzState::rollback(size_t _savepoint)
+{
+    size_t codeSize = m_codeLog.size();
+    auto restore = [](Stamped& _v, FuzzChange const& _change) {
+        _v.value = _change.value;
+        _v.stamp = _change.stamp;
+    };
+    for (size_t i = m_changeLog.size(); i > _savepoint; --i)
+    {
+        FuzzChange const& change = m_changeLog[i - 1];
+        switch (change.kind)
+        {
+        case FuzzChange::Alive:
+            m_accounts[change.index].second.alive = bool(change.value);
+            break;
+        case FuzzChange::Nonce:
+            restore(m_accounts[change.index].second.nonce, change);
+            break;
+        case FuzzChange::Balance:
+            restore(m_accounts[change.index].second.balance, change);
+            break;
+        case FuzzChange::Code:
+        {
+            FuzzAccount& a = m_accounts[change.index].second;
+            codeSize = size_t(change.value);
+            a.code = move(m_codeLog[codeSize].first);
+            a.codeHash = m_codeLog[codeSize].second;
+            break;
+        }
+        case FuzzChange::Epoch:
+            m_accounts[change.index].second.epoch = uint64_t(change.value);
+            break;
+        case FuzzChange::Storage:
+            restore(m_storage[change.index].second, change);
+            m_storage[change.index].second.epoch = change.epoch;
+            break;
+        }
+    }
+    m_changeLog.resize(_savepoint);
+    m_codeLog.resize(codeSize);
+
+    if (_savepoint <= m_base && m_storage.size() > 2 * m_compactedSize + 1024)
+        compactStorage();
+}
+
+void FuzzState::compactStorage()
+{
+    // Slots a Storage change still restores must stay, and so must the old slots of
+    // accounts whose storage epoch an Epoch change can still bring back.
+    vector<bool> logged(m_storage.size());
+    vector<bool> epochLogged(m_accounts.size());
+    for (auto const& change: m_changeLog)
+        if (change.kind == FuzzChange::Storage)
+            logged[change.index] = true;
+        else if (change.kind == FuzzChange::Epoch)
+            epochLogged[change.index] = true;
+
+    FlatTable<SlotKey, Slot, SlotHash> live;
+    vector<uint32_t> moved(m_storage.size());
+    for (size_t i = 0; i < m_accounts.size(); ++i)
+        m_accounts[i].second.slots.clear();
+    for (size_t i = 0; i < m_storage.size(); ++i)
+    {
+        auto const& slot = m_storage[i];
+        size_t const account = m_accounts.find(slot.first.address);
+        FuzzAccount& a = m_accounts[account].second;
+        bool const stale = slot.second.epoch != a.epoch && !epochLogged[account];
+        if (!logged[i] && (!slot.second.value || stale))
+            continue;
+        size_t const j = live.insert(slot.first);
+        live[j].second = slot.second;
+        a.slots.push_back(uint32_t(j));
+        moved[i] = uint32_t(j);
+    }
+    for (auto& change: m_changeLog)
+        if (change.kind == FuzzChange::Storage)
+            change.index = moved[change.index];
+    m_storage = std::move(live);
+    m_compactedSize = m_storage.size();
+}
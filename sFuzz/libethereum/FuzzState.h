@@ -0,0 +1,259 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "StateFace.h"
+#include "StorageMap.h"
+#include <libdevcore/SHA3.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * Open addressing hash table with linear probing.
+ *
+ * Entries are stored densely and never erased, so an entry index stays valid across
+ * rehashes and can be recorded in a changelog.
+ */
+template <class Key, class Value, class Hasher>
+class FlatTable
+{
+public:
+    static constexpr size_t npos = size_t(-1);
+
+    /// @returns the index of the entry for @a _key or npos.
+    size_t find(Key const& _key) const
+    {
+        if (m_index.empty())
+            return npos;
+        size_t const mask = m_index.size() - 1;
+        for (size_t i = Hasher()(_key) & mask;; i = (i + 1) & mask)
+        {
+            uint32_t const e = m_index[i];
+            if (!e)
+                return npos;
+            if (m_entries[e - 1].first == _key)
+                return e - 1;
+        }
+    }
+
+    /// @returns the index of the entry for @a _key, adding a default one if missing.
+    size_t insert(Key const& _key)
+    {
+        size_t const found = find(_key);
+        if (found != npos)
+            return found;
+        if ((m_entries.size() + 1) * 2 > m_index.size())
+            grow();
+        m_entries.emplace_back(_key, Value());
+        place(m_entries.size() - 1);
+        return m_entries.size() - 1;
+    }
+
+    std::pair<Key, Value>& operator[](size_t _i) { return m_entries[_i]; }
+    std::pair<Key, Value> const& operator[](size_t _i) const { return m_entries[_i]; }
+    std::vector<std::pair<Key, Value>> const& entries() const { return m_entries; }
+    size_t size() const { return m_entries.size(); }
+
+private:
+    void place(size_t _entry)
+    {
+        size_t const mask = m_index.size() - 1;
+        size_t i = Hasher()(m_entries[_entry].first) & mask;
+        while (m_index[i])
+            i = (i + 1) & mask;
+        m_index[i] = _entry + 1;
+    }
+
+    void grow()
+    {
+        m_index.assign(std::max<size_t>(64, m_index.size() * 2), 0);
+        for (size_t i = 0; i < m_entries.size(); ++i)
+            place(i);
+    }
+
+    std::vector<std::pair<Key, Value>> m_entries;
+    std::vector<uint32_t> m_index;  ///< Entry index + 1, 0 marks an empty bucket.
+};
+
+/**
+ * Flat in-memory world state for fuzzing.
+ *
+ * Accounts and storage slots live in two open addressing tables, there is no trie, no
+ * database and no commit. Modifications append the previous value to a changelog, so
+ * savepoint() is the changelog size and rollback() restores entries back to it and then
+ * truncates the log in one go.
+ *
+ * Each nonce, balance and storage value remembers the savepoint during which it was last
+ * logged. Writing it again before the next savepoint logs nothing, so a slot written in a
+ * loop costs one entry, and rollback is bounded by the number of distinct values touched.
+ *
+ * Storage slots are tagged with the storage epoch of their account and read as zero once
+ * the epoch moved on, so clearStorage() only bumps the epoch. Stale slots are overwritten
+ * in place when written again and dropped when the changelog is rolled back to the last
+ * baseSavepoint(), unless the changelog left below it can still restore them.
+ * Nothing is ever committed, so like a fresh State the original storage value is zero.
+ */
+class FuzzState: public StateFace
+{
+public:
+    explicit FuzzState(u256 const& _accountStartNonce): m_accountStartNonce(_accountStartNonce) {}
+
+    std::pair<ExecutionResult, TransactionReceipt> execute(EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, Transaction const& _t, Permanence _p = Permanence::Committed, OnOpFunc const& _onOp = OnOpFunc()) override;
+
+    bool addressInUse(Address const& _address) const override { return account(_address); }
+    bool accountNonemptyAndExisting(Address const& _address) const override;
+    bool addressHasCode(Address const& _address) const override;
+
+    u256 balance(Address const& _id) const override;
+    void addBalance(Address const& _id, u256 const& _amount) override;
+    void subBalance(Address const& _addr, u256 const& _value) override;
+    void setBalance(Address const& _addr, u256 const& _value) override;
+
+    u256 storage(Address const& _contract, u256 const& _memory) const override;
+    void setStorage(Address const& _contract, u256 const& _location, u256 const& _value) override;
+    u256 originalStorageValue(Address const&, u256 const&) const override { return 0; }
+    void clearStorage(Address const& _contract) override;
+    std::map<h256, std::pair<u256, u256>> storage(Address const& _contract) const override;
+
+    void setCode(Address const& _address, bytes&& _code) override;
+    /// Sets the code of the account to a shared buffer whose hash is already known.
+    void setCode(Address const& _address, std::shared_ptr<bytes const> _code, h256 const& _codeHash);
+    bytes const& code(Address const& _addr) const override;
+    std::shared_ptr<bytes const> sharedCode(Address const& _addr) const override;
+    h256 codeHash(Address const& _contract) const override;
+    size_t codeSize(Address const& _contract) const override { return code(_contract).size(); }
+
+    void kill(Address _a) override;
+
+    void incNonce(Address const& _id) override;
+    void setNonce(Address const& _addr, u256 const& _newNonce) override;
+    u256 getNonce(Address const& _addr) const override;
+    u256 const& requireAccountStartNonce() const override;
+
+    /// @returns the buffer already holding code with hash @a _codeHash, or a new one holding @a _code.
+    std::shared_ptr<bytes const> intern(bytes&& _code, h256 const& _codeHash);
+
+    /// @returns the balance of every account in use.
+    std::unordered_map<Address, u256> addresses() const;
+
+    size_t savepoint() const override { ++m_savepointId; return m_changeLog.size(); }
+    void rollback(size_t _savepoint) override;
+
+    /// Savepoint of a whole transaction sequence, rolling back to it may compact the storage table.
+    size_t baseSavepoint() { m_base = savepoint(); return m_base; }
+
+    /// @returns the number of storage slots held, including stale and zero ones.
+    size_t storageSize() const { return m_storage.size(); }
+
+private:
+    /// A value together with the savepoint id it was last logged under.
+    struct Stamped
+    {
+        u256 value;
+        uint64_t stamp = 0;
+    };
+
+    struct FuzzAccount
+    {
+        bool alive = false;
+        Stamped nonce;
+        Stamped balance;
+        uint64_t epoch = 0;  ///< Storage epoch, slots tagged with another one are cleared.
+        std::shared_ptr<bytes const> code;  ///< Null when there is no code.
+        h256 codeHash = EmptySHA3;
+        std::vector<uint32_t> slots;  ///< Indices of the storage entries of this account.
+    };
+
+    struct Slot: Stamped
+    {
+        uint64_t epoch = 0;
+    };
+
+    struct SlotKey
+    {
+        Address address;
+        u256 key;
+        bool operator==(SlotKey const& _other) const { return key == _other.key && address == _other.address; }
+    };
+
+    struct SlotHash
+    {
+        size_t operator()(SlotKey const& _slot) const
+        {
+            return std::hash<Address>()(_slot.address) ^ hashStorageKey(_slot.key);
+        }
+    };
+
+    /// An atomic changelog entry, value and stamp hold the previous ones.
+    struct FuzzChange
+    {
+        enum Kind: uint8_t { Alive, Nonce, Balance, Code, Epoch, Storage };
+        Kind kind;
+        uint32_t index;  ///< Index in the account or storage table.
+        uint64_t stamp;
+        u256 value;      ///< For Code, the index in m_codeLog. For Epoch, the account epoch.
+        uint64_t epoch;  ///< For Storage, the slot epoch.
+    };
+
+    /// Logs @a _v unless it was already logged since the last savepoint.
+    void record(FuzzChange::Kind _kind, size_t _index, Stamped& _v, uint64_t _epoch = 0)
+    {
+        if (_v.stamp == m_savepointId)
+            return;
+        m_changeLog.push_back({_kind, uint32_t(_index), _v.stamp, _v.value, _epoch});
+        _v.stamp = m_savepointId;
+    }
+
+    /// @returns the storage epoch of @a _addr.
+    uint64_t epoch(Address const& _addr) const
+    {
+        size_t const i = m_accounts.find(_addr);
+        return i == m_accounts.npos ? 0 : m_accounts[i].second.epoch;
+    }
+
+    /// Rebuilds the storage table without the stale and zero slots the changelog cannot restore.
+    void compactStorage();
+
+    /// @returns the account at the given address or nullptr if it is not alive.
+    FuzzAccount const* account(Address const& _addr) const;
+
+    /// @returns the index of the account, creating it if it is not alive.
+    size_t require(Address const& _addr);
+
+    FlatTable<Address, FuzzAccount, std::hash<Address>> m_accounts;
+    FlatTable<SlotKey, Slot, SlotHash> m_storage;
+    size_t m_compactedSize = 0;  ///< Size of m_storage after the last compactStorage().
+    size_t m_base = 0;  ///< Changelog size at the last baseSavepoint().
+    uint64_t m_lastEpoch = 0;
+    std::vector<FuzzChange> m_changeLog;
+    std::vector<std::pair<std::shared_ptr<bytes const>, h256>> m_codeLog;  ///< Code replaced by the Code changes in m_changeLog.
+    std::unordered_map<h256, std::weak_ptr<bytes const>> m_codes;  ///< Interned code by hash.
+    size_t m_internedLive = 0;  ///< Size of m_codes after the last sweep of expired buffers.
+    u256 m_accountStartNonce;
+    /// Bumped by every savepoint(), starts above the initial stamp so the first write is logged.
+    mutable uint64_t m_savepointId = 1;
+};
+
+}
+}
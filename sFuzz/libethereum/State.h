@@ -20,6 +20,7 @@
 #include "Account.h"
 #include "GasPricer.h"
 #include "SecureTrieDB.h"
+#include "StateFace.h"
 #include "Transaction.h"
 #include "TransactionReceipt.h"
 #include <libdevcore/Common.h>
@@ -69,13 +70,6 @@ enum class BaseState
     Empty
 };
 
-enum class Permanence
-{
-    Reverted,
-    Committed,
-    Uncommitted  ///< Uncommitted state for change log readings in tests.
-};
-
 DEV_SIMPLE_EXCEPTION(InvalidAccountStartNonceInState);
 DEV_SIMPLE_EXCEPTION(IncorrectAccountStartNonceInState);
 
@@ -156,7 +150,7 @@ using ChangeLog = std::vector<Change>;
  * changelog and undone. For possible atomic changes list @see Change::Kind.
  * The changelog is managed by savepoint(), rollback() and commit() methods.
  */
-class State
+class State: public StateFace
 {
     friend class ExtVM;
     friend class dev::test::ImportTest;
@@ -210,102 +204,94 @@ public:
 
     /// Execute a given transaction.
     /// This will change the state accordingly.
-    std::pair<ExecutionResult, TransactionReceipt> execute(EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, Transaction const& _t, Permanence _p = Permanence::Committed, OnOpFunc const& _onOp = OnOpFunc());
+    std::pair<ExecutionResult, TransactionReceipt> execute(EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, Transaction const& _t, Permanence _p = Permanence::Committed, OnOpFunc const& _onOp = OnOpFunc()) override;
 
     /// Execute @a _txCount transactions of a given block.
     /// This will change the state accordingly.
     void executeBlockTransactions(Block const& _block, unsigned _txCount, LastBlockHashesFace const& _lastHashes, SealEngineFace const& _sealEngine);
 
     /// Check if the address is in use.
-    bool addressInUse(Address const& _address) const;
+    bool addressInUse(Address const& _address) const override;
 
     /// Check if the account exists in the state and is non empty (nonce > 0 || balance > 0 || code nonempty).
     /// These two notions are equivalent after EIP158.
-    bool accountNonemptyAndExisting(Address const& _address) const;
+    bool accountNonemptyAndExisting(Address const& _address) const override;
 
     /// Check if the address contains executable code.
-    bool addressHasCode(Address const& _address) const;
+    bool addressHasCode(Address const& _address) const override;
 
     /// Get an account's balance.
     /// @returns 0 if the address has never been used.
-    u256 balance(Address const& _id) const;
+    u256 balance(Address const& _id) const override;
 
     /// Add some amount to balance.
     /// Will initialise the address if it has never been used.
-    void addBalance(Address const& _id, u256 const& _amount);
+    void addBalance(Address const& _id, u256 const& _amount) override;
 
     /// Subtract the @p _value amount from the balance of @p _addr account.
     /// @throws NotEnoughCash if the balance of the account is less than the
     /// amount to be subtrackted (also in case the account does not exist).
-    void subBalance(Address const& _addr, u256 const& _value);
+    void subBalance(Address const& _addr, u256 const& _value) override;
 
     /// Set the balance of @p _addr to @p _value.
     /// Will instantiate the address if it has never been used.
-    void setBalance(Address const& _addr, u256 const& _value);
-
-    /**
-     * @brief Transfers "the balance @a _value between two accounts.
-     * @param _from Account from which @a _value will be deducted.
-     * @param _to Account to which @a _value will be added.
-     * @param _value Amount to be transferred.
-     */
-    void transferBalance(Address const& _from, Address const& _to, u256 const& _value) { subBalance(_from, _value); addBalance(_to, _value); }
+    void setBalance(Address const& _addr, u256 const& _value) override;
 
     /// Get the root of the storage of an account.
     h256 storageRoot(Address const& _contract) const;
 
     /// Get the value of a storage position of an account.
     /// @returns 0 if no account exists at that address.
-    u256 storage(Address const& _contract, u256 const& _memory) const;
+    u256 storage(Address const& _contract, u256 const& _memory) const override;
 
     /// Set the value of a storage position of an account.
-    void setStorage(Address const& _contract, u256 const& _location, u256 const& _value);
+    void setStorage(Address const& _contract, u256 const& _location, u256 const& _value) override;
 
     /// Get the original value of a storage position of an account (before modifications saved in
     /// account cache).
     /// @returns 0 if no account exists at that address.
-    u256 originalStorageValue(Address const& _contract, u256 const& _key) const;
+    u256 originalStorageValue(Address const& _contract, u256 const& _key) const override;
 
     /// Clear the storage root hash of an account to the hash of the empty trie.
-    void clearStorage(Address const& _contract);
+    void clearStorage(Address const& _contract) override;
 
     /// Create a contract at the given address (with unset code and unchanged balance).
     void createContract(Address const& _address);
 
     /// Sets the code of the account. Must only be called during / after contract creation.
-    void setCode(Address const& _address, bytes&& _code);
+    void setCode(Address const& _address, bytes&& _code) override;
 
     /// Delete an account (used for processing suicides).
-    void kill(Address _a);
+    void kill(Address _a) override;
 
     /// Get the storage of an account.
     /// @note This is expensive. Don't use it unless you need to.
     /// @returns map of hashed keys to key-value pairs or empty map if no account exists at that address.
-    std::map<h256, std::pair<u256, u256>> storage(Address const& _contract) const;
+    std::map<h256, std::pair<u256, u256>> storage(Address const& _contract) const override;
 
     /// Get the code of an account.
     /// @returns bytes() if no account exists at that address.
     /// @warning The reference to the code is only valid until the access to
     ///          other account. Do not keep it.
-    bytes const& code(Address const& _addr) const;
+    bytes const& code(Address const& _addr) const override;
 
     /// Get the code hash of an account.
     /// @returns EmptySHA3 if no account exists at that address or if there is no code associated with the address.
-    h256 codeHash(Address const& _contract) const;
+    h256 codeHash(Address const& _contract) const override;
 
     /// Get the byte-size of the code of an account.
     /// @returns code(_contract).size(), but utilizes CodeSizeHash.
-    size_t codeSize(Address const& _contract) const;
+    size_t codeSize(Address const& _contract) const override;
 
     /// Increament the account nonce.
-    void incNonce(Address const& _id);
+    void incNonce(Address const& _id) override;
 
     /// Set the account nonce.
-    void setNonce(Address const& _addr, u256 const& _newNonce);
+    void setNonce(Address const& _addr, u256 const& _newNonce) override;
 
     /// Get the account nonce -- the number of transactions it has sent.
     /// @returns 0 if the address has never been used.
-    u256 getNonce(Address const& _addr) const;
+    u256 getNonce(Address const& _addr) const override;
 
     /// The hash of the root of our state tree.
     h256 rootHash() const { return m_state.root(); }
@@ -319,15 +305,15 @@ public:
 
     /// Get the account start nonce. May be required.
     u256 const& accountStartNonce() const { return m_accountStartNonce; }
-    u256 const& requireAccountStartNonce() const;
+    u256 const& requireAccountStartNonce() const override;
     void noteAccountStartNonce(u256 const& _actual);
 
     /// Create a savepoint in the state changelog.
     /// @return The savepoint index that can be used in rollback() function.
-    size_t savepoint() const;
+    size_t savepoint() const override;
 
     /// Revert all recent changes up to the given @p _savepoint savepoint.
-    void rollback(size_t _savepoint);
+    void rollback(size_t _savepoint) override;
 
     ChangeLog const& changeLog() const { return m_changeLog; }
 
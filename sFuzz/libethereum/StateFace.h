@@ -0,0 +1,138 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Transaction.h"
+#include "TransactionReceipt.h"
+#include <libdevcore/Common.h>
+#include <libevm/ExtVMFace.h>
+#include <map>
+#include <memory>
+
+namespace dev
+{
+namespace eth
+{
+
+class SealEngineFace;
+
+enum class Permanence
+{
+    Reverted,
+    Committed,
+    Uncommitted  ///< Uncommitted state for change log readings in tests.
+};
+
+/**
+ * The part of the world state that Executive and ExtVM need to run transactions.
+ *
+ * State implements it on top of the trie. FuzzState implements it as flat in-memory
+ * tables, for callers that never commit and only use savepoint() and rollback().
+ */
+class StateFace
+{
+public:
+    virtual ~StateFace() = default;
+
+    /// Execute a given transaction.
+    virtual std::pair<ExecutionResult, TransactionReceipt> execute(EnvInfo const& _envInfo, SealEngineFace const& _sealEngine, Transaction const& _t, Permanence _p = Permanence::Committed, OnOpFunc const& _onOp = OnOpFunc()) = 0;
+
+    /// Check if the address is in use.
+    virtual bool addressInUse(Address const& _address) const = 0;
+
+    /// Check if the account exists in the state and is non empty (nonce > 0 || balance > 0 || code nonempty).
+    virtual bool accountNonemptyAndExisting(Address const& _address) const = 0;
+
+    /// Check if the address contains executable code.
+    virtual bool addressHasCode(Address const& _address) const = 0;
+
+    /// Get an account's balance.
+    /// @returns 0 if the address has never been used.
+    virtual u256 balance(Address const& _id) const = 0;
+
+    /// Add some amount to balance.
+    /// Will initialise the address if it has never been used.
+    virtual void addBalance(Address const& _id, u256 const& _amount) = 0;
+
+    /// Subtract the @p _value amount from the balance of @p _addr account.
+    /// @throws NotEnoughCash if the balance of the account is less than the amount.
+    virtual void subBalance(Address const& _addr, u256 const& _value) = 0;
+
+    /// Set the balance of @p _addr to @p _value.
+    virtual void setBalance(Address const& _addr, u256 const& _value) = 0;
+
+    /// Transfers the balance @a _value from @a _from to @a _to.
+    void transferBalance(Address const& _from, Address const& _to, u256 const& _value) { subBalance(_from, _value); addBalance(_to, _value); }
+
+    /// Get the value of a storage position of an account.
+    virtual u256 storage(Address const& _contract, u256 const& _memory) const = 0;
+
+    /// Set the value of a storage position of an account.
+    virtual void setStorage(Address const& _contract, u256 const& _location, u256 const& _value) = 0;
+
+    /// Get the value of a storage position before any uncommitted modification.
+    virtual u256 originalStorageValue(Address const& _contract, u256 const& _key) const = 0;
+
+    /// Empty the storage of an account.
+    virtual void clearStorage(Address const& _contract) = 0;
+
+    /// Sets the code of the account.
+    virtual void setCode(Address const& _address, bytes&& _code) = 0;
+
+    /// Delete an account (used for processing suicides).
+    virtual void kill(Address _a) = 0;
+
+    /// Get the storage of an account.
+    /// @returns map of hashed keys to key-value pairs.
+    virtual std::map<h256, std::pair<u256, u256>> storage(Address const& _contract) const = 0;
+
+    /// Get the code of an account.
+    /// @warning The reference is only valid until the next state modification.
+    virtual bytes const& code(Address const& _addr) const = 0;
+
+    /// Get the code of an account as a buffer that can be kept past the next state modification.
+    /// The default copies code(), implementations that already share their code return it directly.
+    virtual std::shared_ptr<bytes const> sharedCode(Address const& _addr) const { return std::make_shared<bytes const>(code(_addr)); }
+
+    /// Get the code hash of an account.
+    virtual h256 codeHash(Address const& _contract) const = 0;
+
+    /// Get the byte-size of the code of an account.
+    virtual size_t codeSize(Address const& _contract) const = 0;
+
+    /// Increament the account nonce.
+    virtual void incNonce(Address const& _id) = 0;
+
+    /// Set the account nonce.
+    virtual void setNonce(Address const& _addr, u256 const& _newNonce) = 0;
+
+    /// Get the account nonce.
+    virtual u256 getNonce(Address const& _addr) const = 0;
+
+    /// Get the account start nonce, throws if it is not known.
+    virtual u256 const& requireAccountStartNonce() const = 0;
+
+    /// Create a savepoint in the state changelog.
+    virtual size_t savepoint() const = 0;
+
+    /// Revert all recent changes up to the given @p _savepoint savepoint.
+    virtual void rollback(size_t _savepoint) = 0;
+};
+
+}
+}
@@ -0,0 +1,255 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+
+/// Hash of a 256-bit storage key. Mixes the limbs directly instead of going through
+/// boost::hash, keys are either small slot numbers or sha3 outputs.
+inline size_t hashStorageKey(u256 const& _key)
+{
+    auto const& backend = _key.backend();
+    uint64_t h = 0;
+    for (unsigned i = 0; i < backend.size(); ++i)
+        h = (h ^ static_cast<uint64_t>(backend.limbs()[i])) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<size_t>(h ^ (h >> 29));
+}
+
+/**
+ * Map of storage keys to values, used for the account storage overlay.
+ *
+ * Entries are kept densely in insertion order. Up to c_smallSize entries they live inline in
+ * the map, without any allocation, and are found by a linear scan. Past that they move to a
+ * vector with an open addressing index using linear probing on top. A cleared slot is stored
+ * as zero like in the trie, erase() moves the last entry into the hole.
+ */
+class StorageMap
+{
+public:
+    using value_type = std::pair<u256, u256>;
+    using iterator = value_type*;
+    using const_iterator = value_type const*;
+
+    static constexpr size_t c_smallSize = 16;
+
+    StorageMap() = default;
+    StorageMap(StorageMap const& _other) { *this = _other; }
+    StorageMap(StorageMap&& _other) noexcept { *this = std::move(_other); }
+    ~StorageMap() { clearSmall(); }
+
+    StorageMap& operator=(StorageMap const& _other)
+    {
+        if (this == &_other)
+            return *this;
+        clear();
+        if (_other.isLarge())
+        {
+            m_large = _other.m_large;
+            m_index = _other.m_index;
+        }
+        else
+            for (auto const& entry: _other)
+                new (small() + m_smallSize++) value_type(entry);
+        return *this;
+    }
+
+    StorageMap& operator=(StorageMap&& _other) noexcept
+    {
+        if (this == &_other)
+            return *this;
+        clear();
+        if (_other.isLarge())
+        {
+            m_large = std::move(_other.m_large);
+            m_index = std::move(_other.m_index);
+            _other.m_large.clear();
+            _other.m_index.clear();
+        }
+        else
+        {
+            for (auto& entry: _other)
+                new (small() + m_smallSize++) value_type(std::move(entry));
+            _other.clearSmall();
+        }
+        return *this;
+    }
+
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+    size_t size() const { return isLarge() ? m_large.size() : m_smallSize; }
+    bool empty() const { return !size(); }
+
+    void clear()
+    {
+        clearSmall();
+        m_large.clear();
+        m_index.clear();
+    }
+
+    const_iterator find(u256 const& _key) const { return begin() + position(_key); }
+    iterator find(u256 const& _key) { return begin() + position(_key); }
+
+    u256& operator[](u256 const& _key)
+    {
+        size_t const i = position(_key);
+        if (i != size())
+            return data()[i].second;
+        if (!isLarge() && m_smallSize < c_smallSize)
+        {
+            new (small() + m_smallSize) value_type(_key, 0);
+            return small()[m_smallSize++].second;
+        }
+        if (!isLarge())
+        {
+            // Past the inline capacity, every entry moves to the vector.
+            m_large.reserve(c_smallSize * 2);
+            for (auto& entry: *this)
+                m_large.push_back(std::move(entry));
+            clearSmall();
+        }
+        m_large.emplace_back(_key, 0);
+        if (!m_index.empty() && m_large.size() * 2 <= m_index.size())
+            place(m_large.size() - 1);
+        else
+            rehash();
+        return m_large.back().second;
+    }
+
+    /// Removes @a _key, the last entry takes its place in the iteration order.
+    /// @returns the number of entries removed.
+    size_t erase(u256 const& _key)
+    {
+        size_t const i = position(_key);
+        size_t const last = size() - 1;
+        if (i == size())
+            return 0;
+        if (isLarge())
+        {
+            unplace(i);
+            if (i != last)
+                m_index[bucket(last)] = uint32_t(i + 1);
+        }
+        value_type* entries = data();
+        if (i != last)
+            entries[i] = std::move(entries[last]);
+        if (isLarge())
+            m_large.pop_back();
+        else
+            small()[--m_smallSize].~value_type();
+        return 1;
+    }
+
+private:
+    bool isLarge() const { return !m_large.empty(); }
+
+    value_type* small() { return reinterpret_cast<value_type*>(m_small); }
+    value_type const* small() const { return reinterpret_cast<value_type const*>(m_small); }
+    value_type* data() { return isLarge() ? m_large.data() : small(); }
+    value_type const* data() const { return isLarge() ? m_large.data() : small(); }
+
+    void clearSmall()
+    {
+        for (size_t i = 0; i < m_smallSize; ++i)
+            small()[i].~value_type();
+        m_smallSize = 0;
+    }
+
+    /// @returns the index of @a _key in the entries or size() if missing.
+    size_t position(u256 const& _key) const
+    {
+        if (m_index.empty())
+        {
+            value_type const* entries = data();
+            for (size_t i = 0; i < size(); ++i)
+                if (entries[i].first == _key)
+                    return i;
+            return size();
+        }
+        size_t const mask = m_index.size() - 1;
+        for (size_t i = hashStorageKey(_key) & mask;; i = (i + 1) & mask)
+        {
+            uint32_t const e = m_index[i];
+            if (!e)
+                return size();
+            if (m_large[e - 1].first == _key)
+                return e - 1;
+        }
+    }
+
+    /// @returns the bucket holding entry @a _entry.
+    size_t bucket(size_t _entry) const
+    {
+        size_t const mask = m_index.size() - 1;
+        size_t i = hashStorageKey(m_large[_entry].first) & mask;
+        while (m_index[i] != _entry + 1)
+            i = (i + 1) & mask;
+        return i;
+    }
+
+    void place(size_t _entry)
+    {
+        size_t const mask = m_index.size() - 1;
+        size_t i = hashStorageKey(m_large[_entry].first) & mask;
+        while (m_index[i])
+            i = (i + 1) & mask;
+        m_index[i] = uint32_t(_entry + 1);
+    }
+
+    /// Empties the bucket of entry @a _entry, shifting back the ones probed past it.
+    void unplace(size_t _entry)
+    {
+        size_t const mask = m_index.size() - 1;
+        size_t hole = bucket(_entry);
+        for (size_t i = (hole + 1) & mask; m_index[i]; i = (i + 1) & mask)
+        {
+            size_t const home = hashStorageKey(m_large[m_index[i] - 1].first) & mask;
+            // The entry stays if its home lies cyclically in (hole, i].
+            if (((i - home) & mask) < ((i - hole) & mask))
+                continue;
+            m_index[hole] = m_index[i];
+            hole = i;
+        }
+        m_index[hole] = 0;
+    }
+
+    void rehash()
+    {
+        m_index.assign(std::max<size_t>(c_smallSize * 4, m_index.size() * 2), 0);
+        for (size_t i = 0; i < m_large.size(); ++i)
+            place(i);
+    }
+
+    /// Inline entries while not large, the first m_smallSize are constructed.
+    typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type m_small[c_smallSize];
+    size_t m_smallSize = 0;
+    std::vector<value_type> m_large;  ///< Entries past c_smallSize, empty while small.
+    std::vector<uint32_t> m_index;  ///< Entry index + 1, 0 marks an empty bucket. Empty while small.
+};
+
+}
+}
@@ -52,7 +52,8 @@ enum class TransactionException
 	StackUnderflow,
 	RevertInstruction,
 	InvalidZeroSignatureFormat,
-	AddressAlreadyUsed
+	AddressAlreadyUsed,
+	StepLimitExceeded		///< Ran past the instruction limit of the interpreter.
 };
 
 enum class CodeDeposit
@@ -3,13 +3,158 @@
 
 #include "EVMC.h"
 
+#include <libaleth-interpreter/interpreter.h>
 #include <libdevcore/Log.h>
+#include <libevm/LegacyVM.h>
 #include <libevm/VMFactory.h>
 
+#include <array>
+#include <atomic>
+#include <cstring>
+
 namespace dev
 {
 namespace eth
 {
+namespace
+{
+/// A traced EVMC execution, rebuilt from the tracer callbacks.
+struct TracedFrame
+{
+    EVMC* vm;
+    ExtVMFace* ext;
+    OnOpFunc const* onOp;
+    std::shared_ptr<LegacyVM::Program const> program;  ///< For the opcodes LegacyVM would run.
+    u256s stack;                                       ///< Bottom first.
+    bytes memory;
+    uint64_t steps;
+};
+
+/// Traced executions of the calling thread, innermost last.
+thread_local std::vector<TracedFrame*> t_tracedFrames;
+
+struct StackEffect
+{
+    int args;
+    int ret;
+};
+
+StackEffect const& stackEffect(Instruction _op)
+{
+    static std::array<StackEffect, 256> const c_effects = []() {
+        std::array<StackEffect, 256> effects;
+        for (unsigned i = 0; i < 256; ++i)
+        {
+            InstructionInfo const info = instructionInfo(Instruction(i));
+            effects[i] = {info.args, info.ret};
+        }
+        return effects;
+    }();
+    return c_effects[uint8_t(_op)];
+}
+
+void traceInstruction(evmc_tracer_context* _context, size_t _pc, evmc_status_code _status,
+    int64_t _gasLeft, size_t _stackItems, evmc_uint256be const* _pushed, size_t _memorySize,
+    size_t _changedOffset, size_t _changedSize, uint8_t const* _changedMemory)
+{
+    auto& frame = *reinterpret_cast<TracedFrame*>(_context);
+    if (!frame.vm->countsSteps())
+        LegacyVM::countStep();
+    if (_status != EVMC_SUCCESS || !*frame.onOp)
+        return;
+
+    // Apply the instruction to the mirrored stack, taking its next position on the way.
+    bytesConstRef const code = frame.ext->code;
+    Instruction const op = _pc < code.size() ? Instruction(code[_pc]) : Instruction::STOP;
+    u256s& stack = frame.stack;
+    uint64_t nextPC = _pc + 1;
+    if (op >= Instruction::DUP1 && op <= Instruction::DUP16)
+    {
+        size_t const n = size_t(op) - size_t(Instruction::DUP1) + 1;
+        if (n <= stack.size())
+            stack.push_back(stack[stack.size() - n]);
+    }
+    else if (op >= Instruction::SWAP1 && op <= Instruction::SWAP16)
+    {
+        size_t const n = size_t(op) - size_t(Instruction::SWAP1) + 1;
+        if (n < stack.size())
+            std::swap(stack.back(), stack[stack.size() - 1 - n]);
+    }
+    else
+    {
+        size_t const size = stack.size();
+        if (op == Instruction::JUMP && size >= 1)
+            nextPC = uint64_t(stack[size - 1]);
+        else if (op == Instruction::JUMPI && size >= 2 && stack[size - 2])
+            nextPC = uint64_t(stack[size - 1]);
+        else if (op >= Instruction::PUSH1 && op <= Instruction::PUSH32)
+            nextPC += size_t(op) - size_t(Instruction::PUSH1) + 1;
+
+        StackEffect const& effect = stackEffect(op);
+        stack.resize(size - std::min<size_t>(effect.args, size));
+        if (effect.ret > 0)
+            stack.push_back(_pushed ? fromEvmC(*_pushed) : 0);
+    }
+    // The VM is authoritative on the height, should the mirror ever drift.
+    stack.resize(_stackItems);
+
+    frame.memory.resize(_memorySize);
+    if (_changedSize)
+        std::memcpy(frame.memory.data() + _changedOffset, _changedMemory, _changedSize);
+
+    switch (op)
+    {
+    case Instruction::STOP:
+    case Instruction::RETURN:
+    case Instruction::REVERT:
+    case Instruction::SUICIDE:
+    case Instruction::INVALID:
+        return;
+    default:
+        break;
+    }
+    bytes const& prepared = frame.program->code;
+    Instruction const next = nextPC < prepared.size() ? Instruction(prepared[nextPC]) : Instruction::STOP;
+    (*frame.onOp)(++frame.steps, nextPC, next, 0, 0, _gasLeft, frame.vm, frame.ext);
+}
+
+/// Pops the traced frame and gives the tracer back to the enclosing one.
+class TracedScope
+{
+public:
+    explicit TracedScope(TracedFrame& _frame): m_frame(_frame)
+    {
+        t_tracedFrames.push_back(&m_frame);
+        m_frame.vm->setTracer(traceInstruction, reinterpret_cast<evmc_tracer_context*>(&m_frame));
+    }
+
+    ~TracedScope()
+    {
+        t_tracedFrames.pop_back();
+        m_frame.vm->setTracer(nullptr, nullptr);
+        if (!t_tracedFrames.empty())
+        {
+            TracedFrame* parent = t_tracedFrames.back();
+            parent->vm->setTracer(traceInstruction, reinterpret_cast<evmc_tracer_context*>(parent));
+        }
+    }
+
+    TracedScope(TracedScope const&) = delete;
+    TracedScope& operator=(TracedScope const&) = delete;
+
+private:
+    TracedFrame& m_frame;
+};
+
+TracedFrame const* tracedFrame(VMFace const* _vm)
+{
+    for (auto it = t_tracedFrames.rbegin(); it != t_tracedFrames.rend(); ++it)
+        if ((*it)->vm == _vm)
+            return *it;
+    return nullptr;
+}
+}  // namespace
+
 EVM::EVM(evmc_instance* _instance) noexcept : m_instance(_instance)
 {
     assert(m_instance != nullptr);
@@ -21,6 +166,14 @@ EVM::EVM(evmc_instance* _instance) noexcept : m_instance(_instance)
             cwarn << "Failed to set EVMC parameter '" << pair.first << "'";
 }
 
+bool EVM::setTracer(evmc_trace_callback _callback, evmc_tracer_context* _context) noexcept
+{
+    if (!m_instance->set_tracer)
+        return false;
+    evmc_set_tracer(m_instance, _callback, _context);
+    return true;
+}
+
 /// Handy wrapper for evmc_execute().
 EVM::Result EVM::execute(ExtVMFace& _ext, int64_t gas)
 {
@@ -35,6 +188,11 @@ EVM::Result EVM::execute(ExtVMFace& _ext, int64_t gas)
         evmc_execute(m_instance, &_ext, mode, &msg, _ext.code.data(), _ext.code.size())};
 }
 
+EVMC::EVMC(evmc_instance* _instance)
+  : EVM(_instance), m_countsSteps(_instance == evmc_create_interpreter())
+{
+}
+
 owning_bytes_ref EVMC::exec(u256& io_gas, ExtVMFace& _ext, const OnOpFunc& _onOp)
 {
     assert(_ext.envInfo().number() >= 0);
@@ -50,7 +208,35 @@ owning_bytes_ref EVMC::exec(u256& io_gas, ExtVMFace& _ext, const OnOpFunc& _onOp
     assert(_ext.depth <= static_cast<size_t>(std::numeric_limits<int32_t>::max()));
 
     auto gas = static_cast<int64_t>(io_gas);
+
+    // Frames are traced even without hooks, so their instructions count against the step
+    // limit of LegacyVM. Without tracer support the hooks and the step limit miss them, except
+    // on the in-tree interpreter which counts and stops on the limit itself.
+    TracedFrame frame{this, &_ext, &_onOp, nullptr, {}, {}, 0};
+    std::unique_ptr<TracedScope> traced;
+    if (setTracer(nullptr, nullptr))
+    {
+        traced.reset(new TracedScope(frame));
+        if (_onOp)
+        {
+            frame.program = LegacyVM::prepare(_ext);
+            _onOp(0, 0, Instruction(frame.program->code[0]), 0, 0, gas, this, &_ext);
+        }
+    }
+    else if (_onOp)
+    {
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true))
+            cwarn << "EVMC VM " << name() << " does not support tracing, instruction hooks are skipped";
+    }
+
     EVM::Result r = execute(_ext, gas);
+    bool const traceable = bool(traced);
+    traced.reset();
+
+    // The tracer cannot stop other VMs, so a frame that ran past the limit fails once it returns.
+    if ((traceable || countsSteps()) && LegacyVM::stepLimitExceeded())
+        BOOST_THROW_EXCEPTION(StepLimitExceeded());
 
     switch (r.status())
     {
@@ -102,6 +288,25 @@ owning_bytes_ref EVMC::exec(u256& io_gas, ExtVMFace& _ext, const OnOpFunc& _onOp
     }
 }
 
+u256s EVMC::stack() const
+{
+    TracedFrame const* frame = tracedFrame(this);
+    return frame ? frame->stack : u256s{};
+}
+
+bytes const& EVMC::memory() const
+{
+    TracedFrame const* frame = tracedFrame(this);
+    return frame ? frame->memory : NullBytes;
+}
+
+OnOpFunc tracedOnOp(ExtVMFace const& _ext)
+{
+    if (!t_tracedFrames.empty() && t_tracedFrames.back()->ext == &_ext)
+        return *t_tracedFrames.back()->onOp;
+    return {};
+}
+
 evmc_revision EVM::toRevision(EVMSchedule const& _schedule)
 {
     if (_schedule.haveCreate2)
@@ -73,6 +73,10 @@ public:
     /// Handy wrapper for evmc_execute().
     Result execute(ExtVMFace& _ext, int64_t gas);
 
+    /// Handy wrapper for evmc_set_tracer().
+    /// @returns false if the VM does not support tracing.
+    bool setTracer(evmc_trace_callback _callback, evmc_tracer_context* _context) noexcept;
+
     /// Translate the EVMSchedule to EVMC revision.
     static evmc_revision toRevision(EVMSchedule const& _schedule);
 
@@ -83,12 +87,30 @@ private:
 
 
 /// The wrapper implementing the VMFace interface with a EVMC VM as a backend.
+///
+/// With an OnOpFunc the execution is traced: the stack and memory are mirrored from the
+/// EVMC tracer callbacks, which report an instruction after it ran, and the OnOpFunc is
+/// called for the instruction that follows, as LegacyVM does before running it.
 class EVMC : public EVM, public VMFace
 {
 public:
-    explicit EVMC(evmc_instance* _instance) : EVM(_instance) {}
+    explicit EVMC(evmc_instance* _instance);
 
     owning_bytes_ref exec(u256& io_gas, ExtVMFace& _ext, OnOpFunc const& _onOp) final;
+
+    u256s stack() const override;
+    bytes const& memory() const override;
+
+    /// True for the in-tree interpreter, which counts its instructions against the step limit
+    /// of LegacyVM itself.
+    bool countsSteps() const noexcept { return m_countsSteps; }
+
+private:
+    bool const m_countsSteps;
 };
+
+/// @returns the OnOpFunc of the traced EVMC execution running on @a _ext, empty if there is none.
+/// Frames called through the EVMC host interface are traced with it as well.
+OnOpFunc tracedOnOp(ExtVMFace const& _ext);
 }
 }
@@ -16,6 +16,7 @@
 */
 
 #include "ExtVMFace.h"
+#include "EVMC.h"
 
 #include <evmc/helpers.h>
 
@@ -208,7 +209,7 @@ evmc_result create(ExtVMFace& _env, evmc_message const* _msg) noexcept
     // ExtVM::create takes the sender address from .myAddress.
     assert(fromEvmC(_msg->sender) == _env.myAddress);
 
-    CreateResult result = _env.create(value, gas, init, opcode, salt, {});
+    CreateResult result = _env.create(value, gas, init, opcode, salt, tracedOnOp(_env));
     evmc_result evmcResult = {};
     evmcResult.status_code = result.status;
     evmcResult.gas_left = static_cast<int64_t>(gas);
@@ -262,7 +263,7 @@ evmc_result call(evmc_context* _context, evmc_message const* _msg) noexcept
         _msg->kind == EVMC_CALL ? params.codeAddress : env.myAddress;
     params.data = {_msg->input_data, _msg->input_size};
     params.staticCall = (_msg->flags & EVMC_STATIC) != 0;
-    params.onOp = {};
+    params.onOp = tracedOnOp(env);
 
     CallResult result = env.call(params);
     evmc_result evmcResult = {};
@@ -310,7 +311,7 @@ evmc_host_interface const hostInterface = {
 }
 
 ExtVMFace::ExtVMFace(EnvInfo const& _envInfo, Address _myAddress, Address _caller, Address _origin,
-    u256 _value, u256 _gasPrice, bytesConstRef _data, bytes _code, h256 const& _codeHash,
+    u256 _value, u256 _gasPrice, bytesConstRef _data, std::shared_ptr<bytes const> _code, h256 const& _codeHash,
     unsigned _depth, bool _isCreate, bool _staticCall)
   : evmc_context{&hostInterface},
     m_envInfo(_envInfo),
@@ -320,7 +321,8 @@ ExtVMFace::ExtVMFace(EnvInfo const& _envInfo, Address _myAddress, Address _calle
     value(_value),
     gasPrice(_gasPrice),
     data(_data),
-    code(std::move(_code)),
+    code(_code ? bytesConstRef(_code.get()) : bytesConstRef()),
+    codeOwner(std::move(_code)),
     codeHash(_codeHash),
     depth(_depth),
     isCreate(_isCreate),
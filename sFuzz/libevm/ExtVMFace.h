@@ -205,7 +205,7 @@ class ExtVMFace: public evmc_context
 public:
     /// Full constructor.
     ExtVMFace(EnvInfo const& _envInfo, Address _myAddress, Address _caller, Address _origin,
-        u256 _value, u256 _gasPrice, bytesConstRef _data, bytes _code, h256 const& _codeHash,
+        u256 _value, u256 _gasPrice, bytesConstRef _data, std::shared_ptr<bytes const> _code, h256 const& _codeHash,
         unsigned _depth, bool _isCreate, bool _staticCall);
 
     virtual ~ExtVMFace() = default;
@@ -269,7 +269,8 @@ public:
     u256 value;         ///< Value (in Wei) that was passed to this address.
     u256 gasPrice;      ///< Price of gas (that we already paid).
     bytesConstRef data;       ///< Current input data.
-    bytes code;               ///< Current code that is executing.
+    bytesConstRef code;       ///< Current code that is executing.
+    std::shared_ptr<bytes const> codeOwner;  ///< Keeps code alive, shared with the state it came from.
     h256 codeHash;            ///< SHA3 hash of the executing code
     u256 salt;                ///< Values used in new address construction by CREATE2 
     SubState sub;             ///< Sub-band VM state (suicides, refund counter, logs).
@@ -17,6 +17,8 @@
 
 #include "LegacyVM.h"
 
+#include <libaleth-interpreter/interpreter.h>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -36,7 +38,102 @@ template <class S> S modWorkaround(S const& _a, S const& _b)
     return (S)(s512(_a) % s512(_b));
 }
 
-bytes LegacyVM::payload = bytes(0, 0);
+
+//
+// memo cache for SHA3 of 64 byte inputs, mappings hash keccak256(key . slot) on every access
+//
+
+namespace
+{
+struct Sha3MemoEntry
+{
+    std::array<uint64_t, 8> input;
+    h256 output;
+    bool used = false;
+};
+
+/// Direct mapped, an input hashing to a taken entry replaces it.
+struct Sha3Memo
+{
+    static size_t const c_size = 4096;
+    std::vector<Sha3MemoEntry> entries = std::vector<Sha3MemoEntry>(c_size);
+    uint64_t hits = 0;
+    uint64_t lookups = 0;
+};
+
+thread_local Sha3Memo t_sha3Memo;
+}
+
+h256 LegacyVM::sha3Memo(byte const* _input)
+{
+    std::array<uint64_t, 8> words;
+    memcpy(words.data(), _input, sizeof(words));
+    uint64_t h = 0;
+    for (uint64_t w: words)
+        h = (h ^ w) * 0x9e3779b97f4a7c15ULL;
+
+    Sha3Memo& memo = t_sha3Memo;
+    Sha3MemoEntry& entry = memo.entries[(h >> 32) & (Sha3Memo::c_size - 1)];
+    ++memo.lookups;
+    if (entry.used && entry.input == words)
+    {
+        ++memo.hits;
+        return entry.output;
+    }
+    entry.input = words;
+    entry.output = sha3(bytesConstRef(_input, sizeof(words)));
+    entry.used = true;
+    return entry.output;
+}
+
+std::pair<uint64_t, uint64_t> LegacyVM::sha3MemoStats()
+{
+    return {t_sha3Memo.hits, t_sha3Memo.lookups};
+}
+
+void LegacyVM::resetSha3MemoStats()
+{
+    t_sha3Memo.hits = 0;
+    t_sha3Memo.lookups = 0;
+}
+
+//
+// instruction budget shared by all frames of a thread, bounds loops that gas alone would not
+//
+
+namespace
+{
+struct StepBudget
+{
+    uint64_t steps = 0;
+    uint64_t limit = std::numeric_limits<uint64_t>::max();
+};
+
+thread_local StepBudget t_stepBudget;
+}
+
+void LegacyVM::setStepLimit(uint64_t _limit)
+{
+    t_stepBudget.steps = 0;
+    t_stepBudget.limit = _limit;
+    // The in-tree interpreter stops on the same budget when run through EVMC.
+    evmc_interpreter_set_step_budget(&t_stepBudget.steps, &t_stepBudget.limit);
+}
+
+uint64_t LegacyVM::steps()
+{
+    return t_stepBudget.steps;
+}
+
+bool LegacyVM::stepLimitExceeded()
+{
+    return t_stepBudget.steps > t_stepBudget.limit;
+}
+
+void LegacyVM::countStep()
+{
+    ++t_stepBudget.steps;
+}
 
 //
 // for decoding destinations of JUMPTO, JUMPV, JUMPSUB and JUMPSUBV
@@ -200,6 +297,10 @@ void LegacyVM::logGasMem()
 
 void LegacyVM::fetchInstruction()
 {
+    StepBudget& budget = t_stepBudget;
+    if (++budget.steps > budget.limit)
+        throwStepLimitExceeded();
+
     m_OP = Instruction(m_code[m_PC]);
     const InstructionMetric& metric = c_metrics[static_cast<size_t>(m_OP)];
     adjustStack(metric.args, metric.ret);
@@ -400,7 +501,10 @@ void LegacyVM::interpretCases()
 
             uint64_t inOff = (uint64_t)m_SP[0];
             uint64_t inSize = (uint64_t)m_SP[1];
-            m_SPP[0] = (u256)sha3(bytesConstRef(m_mem.data() + inOff, inSize));
+            if (inSize == 64)
+                m_SPP[0] = (u256)sha3Memo(m_mem.data() + inOff);
+            else
+                m_SPP[0] = (u256)sha3(bytesConstRef(m_mem.data() + inOff, inSize));
         }
         NEXT
 
@@ -755,7 +859,7 @@ void LegacyVM::interpretCases()
             ON_OP();
             updateIOGas();
 
-            m_PC = decodeJumpDest(m_code.data(), m_PC);
+            m_PC = decodeJumpDest(m_code, m_PC);
         }
         CONTINUE
 
@@ -765,7 +869,7 @@ void LegacyVM::interpretCases()
             updateIOGas();
 
             if (m_SP[0])
-                m_PC = decodeJumpDest(m_code.data(), m_PC);
+                m_PC = decodeJumpDest(m_code, m_PC);
             else
                 ++m_PC;
         }
@@ -775,7 +879,7 @@ void LegacyVM::interpretCases()
         {
             ON_OP();
             updateIOGas();
-            m_PC = decodeJumpvDest(m_code.data(), m_PC, byte(m_SP[0]));
+            m_PC = decodeJumpvDest(m_code, m_PC, byte(m_SP[0]));
         }
         CONTINUE
 
@@ -784,7 +888,7 @@ void LegacyVM::interpretCases()
             ON_OP();
             updateIOGas();
             *m_RP++ = m_PC++;
-            m_PC = decodeJumpDest(m_code.data(), m_PC);
+            m_PC = decodeJumpDest(m_code, m_PC);
         }
         CONTINUE
 
@@ -793,7 +897,7 @@ void LegacyVM::interpretCases()
             ON_OP();
             updateIOGas();
             *m_RP++ = m_PC;
-            m_PC = decodeJumpvDest(m_code.data(), m_PC, byte(m_SP[0]));
+            m_PC = decodeJumpvDest(m_code, m_PC, byte(m_SP[0]));
         }
         CONTINUE
 
@@ -1358,7 +1462,7 @@ void LegacyVM::interpretCases()
             updateMem(memNeed(m_SP[0], m_SP[2]));
             updateIOGas();
 
-            copyDataToMemory(&m_ext->code, m_SP);
+            copyDataToMemory(m_ext->code, m_SP);
         }
         NEXT
 
@@ -37,13 +37,40 @@ public:
     void validateSubroutine(uint64_t _PC, uint64_t* _rp, u256* _sp);
 #endif
 
-    bytes const& memory() const { return m_mem; }
-    u256s stack() const {
+    bytes const& memory() const override { return m_mem; }
+    u256s stack() const override {
         u256s stack(m_SP, m_stackEnd);
         reverse(stack.begin(), stack.end());
         return stack;
     };
-    static bytes payload;
+
+    /// Code after optimize(), immutable and shared by every frame running the same code hash.
+    struct Program
+    {
+        bytes code;                        ///< Rewritten code, extended by zero bytes.
+        std::vector<u256> pool;            ///< Constants of PUSHC.
+        std::vector<bool> jumpDests;       ///< Bit per code byte, set on JUMPDEST instructions.
+        std::vector<uint64_t> beginSubs;
+    };
+
+    /// @returns the program for the code of @a _ext, from the thread's cache when its code hash was seen.
+    static std::shared_ptr<Program const> prepare(ExtVMFace const& _ext);
+
+    /// Hits and lookups of the SHA3 memo cache of the calling thread.
+    static std::pair<uint64_t, uint64_t> sha3MemoStats();
+
+    /// Zeroes the counters of sha3MemoStats(), the cached hashes stay valid and are kept.
+    static void resetSha3MemoStats();
+
+    /// Limits the number of instructions the calling thread runs, across all frames, until the
+    /// next call. Past the limit every frame fails with StepLimitExceeded.
+    static void setStepLimit(uint64_t _limit);
+    /// Instructions run by the calling thread since the last setStepLimit().
+    static uint64_t steps();
+    /// @returns true if the limit of the last setStepLimit() was hit.
+    static bool stepLimitExceeded();
+    /// Counts an instruction another VM ran against the same budget.
+    static void countStep();
 
 private:
 
@@ -55,7 +82,12 @@ private:
     static std::array<InstructionMetric, 256> c_metrics;
     static void initMetrics();
     static u256 exp256(u256 _base, u256 _exponent);
-    void copyCode(int);
+    static h256 sha3Memo(byte const* _input);
+
+    using CachedProgram = std::pair<h256, std::shared_ptr<Program const>>;
+    /// @returns the slot of the thread's program cache for @a _codeHash, it may hold another program.
+    static CachedProgram& programCacheSlot(h256 const& _codeHash);
+    static void copyCode(bytes& o_code, bytesConstRef _code, int _extraBytes);
     typedef void (LegacyVM::*MemFnPtr)();
     MemFnPtr m_bounce = 0;
     MemFnPtr m_onFail = 0;
@@ -68,8 +100,9 @@ private:
     // space for memory
     bytes m_mem;
 
-    // space for code
-    bytes m_code;
+    // space for code, points into m_program
+    std::shared_ptr<Program const> m_program;
+    byte const* m_code = nullptr;
 
     /// RETURNDATA buffer for memory returned from direct subcalls.
     bytes m_returnData;
@@ -87,8 +120,8 @@ private:
     std::vector<size_t> m_frameSize;
 #endif
 
-    // constant pool
-    std::vector<u256> m_pool;
+    // constant pool, points into m_program
+    u256 const* m_pool = nullptr;
 
     // interpreter state
     Instruction m_OP;                   // current operation
@@ -126,9 +159,8 @@ private:
     void throwRevertInstruction(owning_bytes_ref&& _output);
     void throwDisallowedStateChange();
     void throwBufferOverrun(bigint const& _enfOfAccess);
+    void throwStepLimitExceeded();
 
-    std::vector<uint64_t> m_beginSubs;
-    std::vector<uint64_t> m_jumpDests;
     int64_t verifyJumpDest(u256 const& _dest, bool _throw = true);
 
     void onOperation();
@@ -60,6 +60,11 @@ void LegacyVM::throwDisallowedStateChange()
     BOOST_THROW_EXCEPTION(DisallowedStateChange());
 }
 
+void LegacyVM::throwStepLimitExceeded()
+{
+    BOOST_THROW_EXCEPTION(StepLimitExceeded());
+}
+
 // throwBadStack is called from fetchInstruction() -> adjustStack()
 // its the only exception that can happen before ON_OP() log is done for an opcode case in VM.cpp
 // so the call to m_onFail is needed here
@@ -100,9 +105,10 @@ int64_t LegacyVM::verifyJumpDest(u256 const& _dest, bool _throw)
     if (_dest <= 0x7FFFFFFFFFFFFFFF) {
 
         // check for within bounds and to a jump destination
-        // use binary search of array because hashtable collisions are exploitable
+        // use the bitmap built with the program, a lookup per jump
         uint64_t pc = uint64_t(_dest);
-        if (std::binary_search(m_jumpDests.begin(), m_jumpDests.end(), pc))
+        std::vector<bool> const& jumpDests = m_program->jumpDests;
+        if (pc < jumpDests.size() && jumpDests[pc])
             return pc;
     }
     if (_throw)
@@ -273,12 +279,7 @@ bool LegacyVM::caseCallSetup(CallParameters *callParams, bytesRef& o_output)
         callParams->onOp = m_onOp;
         callParams->senderAddress = m_OP == Instruction::DELEGATECALL ? m_ext->caller : m_ext->myAddress;
         callParams->receiveAddress = (m_OP == Instruction::CALL || m_OP == Instruction::STATICCALL) ? callParams->codeAddress : m_ext->myAddress;
-        if (m_ext->myAddress == Address(0xf0)) {
-            auto size = LegacyVM::payload.size();
-            callParams->data = bytesConstRef(LegacyVM::payload.data(), size);
-        } else {
-            callParams->data = bytesConstRef(m_mem.data() + inOff, inSize);
-        }
+        callParams->data = bytesConstRef(m_mem.data() + inOff, inSize);
         o_output = bytesRef(m_mem.data() + outOff, outSize);
         return true;
     }
@@ -39,29 +39,55 @@ void LegacyVM::initMetrics()
 	(void)done;
 }
 
-void LegacyVM::copyCode(int _extraBytes)
+void LegacyVM::copyCode(bytes& o_code, bytesConstRef _code, int _extraBytes)
 {
 	// Copy code so that it can be safely modified and extend code by
 	// _extraBytes zero bytes to allow reading virtual data at the end
 	// of the code without bounds checks.
-	auto extendedSize = m_ext->code.size() + _extraBytes;
-	m_code.reserve(extendedSize);
-	m_code = m_ext->code;
-	m_code.resize(extendedSize);
+	auto extendedSize = _code.size() + _extraBytes;
+	o_code.reserve(extendedSize);
+	o_code.assign(_code.begin(), _code.end());
+	o_code.resize(extendedSize);
+}
+
+LegacyVM::CachedProgram& LegacyVM::programCacheSlot(h256 const& _codeHash)
+{
+	// Direct mapped like the SHA3 memo, creation code changes with every set of
+	// constructor arguments so its programs replace each other instead of piling up.
+	static size_t const c_size = 1024;
+	thread_local std::vector<CachedProgram> t_programs(c_size);
+	size_t const slot = (size_t(_codeHash[0]) << 8 | _codeHash[1]) & (c_size - 1);
+	return t_programs[slot];
 }
 
 void LegacyVM::optimize()
 {
-	copyCode(33);
+	m_program = prepare(*m_ext);
+	m_code = m_program->code.data();
+	m_pool = m_program->pool.data();
+}
+
+std::shared_ptr<LegacyVM::Program const> LegacyVM::prepare(ExtVMFace const& _ext)
+{
+	// Code is rewritten once per code hash, later frames only take a reference.
+	h256 const& codeHash = _ext.codeHash;
+	CachedProgram* cached = codeHash ? &programCacheSlot(codeHash) : nullptr;
+	if (cached && cached->first == codeHash && cached->second)
+		return cached->second;
 
-	size_t const nBytes = m_ext->code.size();
+	auto program = std::make_shared<Program>();
+	bytes& code = program->code;
+	copyCode(code, _ext.code, 33);
+
+	size_t const nBytes = _ext.code.size();
+	program->jumpDests.resize(nBytes);
 
 	// build a table of jump destinations for use in verifyJumpDest
 	
 	TRACE_STR(1, "Build JUMPDEST table")
 	for (size_t pc = 0; pc < nBytes; ++pc)
 	{
-		Instruction op = Instruction(m_code[pc]);
+		Instruction op = Instruction(code[pc]);
 		TRACE_OP(2, pc, op);
 				
 		// make synthetic ops in user code trigger invalid instruction if run
@@ -72,12 +98,12 @@ void LegacyVM::optimize()
 		)
 		{
 			TRACE_OP(1, pc, op);
-			m_code[pc] = (byte)Instruction::INVALID;
+			code[pc] = (byte)Instruction::INVALID;
 		}
 
 		if (op == Instruction::JUMPDEST)
 		{
-			m_jumpDests.push_back(pc);
+			program->jumpDests[pc] = true;
 		}
 		else if (
 			(byte)Instruction::PUSH1 <= (byte)op &&
@@ -98,11 +124,11 @@ void LegacyVM::optimize()
 		else if (op == Instruction::JUMPV || op == Instruction::JUMPSUBV)
 		{
 			++pc;
-			pc += 4 * m_code[pc];  // number of 4-byte dests followed by table
+			pc += 4 * code[pc];  // number of 4-byte dests followed by table
 		}
 		else if (op == Instruction::BEGINSUB)
 		{
-			m_beginSubs.push_back(pc);
+			program->beginSubs.push_back(pc);
 		}
 		else if (op == Instruction::BEGINDATA)
 		{
@@ -117,16 +143,16 @@ void LegacyVM::optimize()
 	for (size_t pc = 0; pc < nBytes; ++pc)
 	{
 		u256 val = 0;
-		Instruction op = Instruction(m_code[pc]);
+		Instruction op = Instruction(code[pc]);
 
 		if ((byte)Instruction::PUSH1 <= (byte)op && (byte)op <= (byte)Instruction::PUSH32)
 		{
 			byte nPush = (byte)op - (byte)Instruction::PUSH1 + 1;
 
 			// decode pushed bytes to integral value
-			val = m_code[pc+1];
+			val = code[pc+1];
 			for (uint64_t i = pc+2, n = nPush; --n; ++i) {
-				val = (val << 8) | m_code[i];
+				val = (val << 8) | code[i];
 			}
 
 		#if EVM_USE_CONSTANT_POOL
@@ -136,16 +162,16 @@ void LegacyVM::optimize()
 			// followed by one byte count of remaining pushed bytes
 			if (5 < nPush)
 			{
-				uint16_t pool_off = m_pool.size();
+				uint16_t pool_off = program->pool.size();
 				TRACE_VAL(1, "stash", val);
 				TRACE_VAL(1, "... in pool at offset" , pool_off);
-				m_pool.push_back(val);
+				program->pool.push_back(val);
 
 				TRACE_PRE_OPT(1, pc, op);
-				m_code[pc] = byte(op = Instruction::PUSHC);
-				m_code[pc+3] = nPush - 2;
-				m_code[pc+2] = pool_off & 0xff;
-				m_code[pc+1] = pool_off >> 8;
+				code[pc] = byte(op = Instruction::PUSHC);
+				code[pc+3] = nPush - 2;
+				code[pc+2] = pool_off & 0xff;
+				code[pc+1] = pool_off >> 8;
 				TRACE_POST_OPT(1, pc, op);
 			}
 
@@ -153,18 +179,17 @@ void LegacyVM::optimize()
 
 		#if EVM_REPLACE_CONST_JUMP	
 			// replace JUMP or JUMPI to constant location with JUMPC or JUMPCI
-			// verifyJumpDest is M = log(number of jump destinations)
-			// outer loop is N = number of bytes in code array
-			// so complexity is N log M, worst case is N log N
+			// destinations are checked against the bitmap built above,
+			// so the pass stays linear in the number of bytes in code array
 			size_t i = pc + nPush + 1;
-			op = Instruction(m_code[i]);
+			op = Instruction(code[i]);
 			if (op == Instruction::JUMP)
 			{
 				TRACE_VAL(1, "Replace const JUMP with JUMPC to", val)
 				TRACE_PRE_OPT(1, i, op);
 				
-				if (0 <= verifyJumpDest(val, false))
-					m_code[i] = byte(op = Instruction::JUMPC);
+				if (val < nBytes && program->jumpDests[size_t(val)])
+					code[i] = byte(op = Instruction::JUMPC);
 				
 				TRACE_POST_OPT(1, i, op);
 			}
@@ -173,8 +198,8 @@ void LegacyVM::optimize()
 				TRACE_VAL(1, "Replace const JUMPI with JUMPCI to", val)
 				TRACE_PRE_OPT(1, i, op);
 				
-				if (0 <= verifyJumpDest(val, false))
-					m_code[i] = byte(op = Instruction::JUMPCI);
+				if (val < nBytes && program->jumpDests[size_t(val)])
+					code[i] = byte(op = Instruction::JUMPCI);
 				
 				TRACE_POST_OPT(1, i, op);
 			}
@@ -185,6 +210,10 @@ void LegacyVM::optimize()
 	}
 	TRACE_STR(1, "Finished optimizations")
 #endif	
+
+	if (cached)
+		*cached = {codeHash, program};
+	return program;
 }
 
 
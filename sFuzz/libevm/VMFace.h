@@ -34,6 +34,7 @@ ETH_SIMPLE_EXCEPTION_VM(OutOfStack);
 ETH_SIMPLE_EXCEPTION_VM(StackUnderflow);
 ETH_SIMPLE_EXCEPTION_VM(DisallowedStateChange);
 ETH_SIMPLE_EXCEPTION_VM(BufferOverrun);
+ETH_SIMPLE_EXCEPTION_VM(StepLimitExceeded);
 
 /// Reports VM internal error. This is not based on VMException because it must be handled
 /// differently than defined consensus exceptions.
@@ -70,6 +71,12 @@ public:
 
 	/// VM implementation
 	virtual owning_bytes_ref exec(u256& io_gas, ExtVMFace& _ext, OnOpFunc const& _onOp) = 0;
+
+	/// Stack of the running frame, bottom first, as seen by the OnOpFunc of the current instruction.
+	virtual u256s stack() const { return {}; }
+
+	/// Memory of the running frame, as seen by the OnOpFunc of the current instruction.
+	virtual bytes const& memory() const { return NullBytes; }
 };
 
 /// Helpers:
@@ -33,11 +33,47 @@ namespace
 {
 auto g_kind = VMKind::Legacy;
 
-/// The pointer to EVMC create function in DLL EVMC VM.
+/// The path of the EVMC DLL VM.
 ///
 /// This variable is only written once when processing command line arguments,
 /// so access is thread-safe.
-std::unique_ptr<EVMC> g_evmcDll;
+std::string g_evmcDllPath;
+
+/// The EVMC DLL VM of the calling thread.
+///
+/// The tracer context of an EVMC instance is shared by all its executions, so every thread
+/// creates its own instance from the DLL.
+thread_local std::unique_ptr<EVMC> t_evmcDll;
+
+/// Loads the EVMC VM DLL at @a _path and creates an instance.
+/// @throws on any loader error.
+std::unique_ptr<EVMC> loadEvmcDll(const std::string& _path)
+{
+    evmc_loader_error_code ec;
+    evmc_instance *instance = evmc_load_and_create(_path.c_str(), &ec);
+    assert(ec == EVMC_LOADER_SUCCESS || instance == nullptr);
+
+    switch (ec)
+    {
+    case EVMC_LOADER_SUCCESS:
+        break;
+    case EVMC_LOADER_CANNOT_OPEN:
+        BOOST_THROW_EXCEPTION(
+            po::validation_error(po::validation_error::invalid_option_value, "vm", _path, 1));
+    case EVMC_LOADER_SYMBOL_NOT_FOUND:
+        BOOST_THROW_EXCEPTION(std::system_error(std::make_error_code(std::errc::invalid_seek),
+            "loading " + _path + " failed: EVMC create function not found"));
+    case EVMC_LOADER_ABI_VERSION_MISMATCH:
+        BOOST_THROW_EXCEPTION(std::system_error(std::make_error_code(std::errc::invalid_argument),
+            "loading " + _path + " failed: EVMC ABI version mismatch"));
+    default:
+        BOOST_THROW_EXCEPTION(
+            std::system_error(std::error_code(static_cast<int>(ec), std::generic_category()),
+                "loading " + _path + " failed"));
+    }
+
+    return std::unique_ptr<EVMC>{new EVMC{instance}};
+}
 
 /// A helper type to build the tabled of VM implementations.
 ///
@@ -74,34 +110,12 @@ void setVMKind(const std::string& _name)
     g_kind = VMKind::DLL;
 
     // Release previous instance
-    g_evmcDll.reset();
-
-    evmc_loader_error_code ec;
-    evmc_instance *instance = evmc_load_and_create(_name.c_str(), &ec);
-    assert(ec == EVMC_LOADER_SUCCESS || instance == nullptr);
-
-    switch (ec)
-    {
-    case EVMC_LOADER_SUCCESS:
-        break;
-    case EVMC_LOADER_CANNOT_OPEN:
-        BOOST_THROW_EXCEPTION(
-            po::validation_error(po::validation_error::invalid_option_value, "vm", _name, 1));
-    case EVMC_LOADER_SYMBOL_NOT_FOUND:
-        BOOST_THROW_EXCEPTION(std::system_error(std::make_error_code(std::errc::invalid_seek),
-            "loading " + _name + " failed: EVMC create function not found"));
-    case EVMC_LOADER_ABI_VERSION_MISMATCH:
-        BOOST_THROW_EXCEPTION(std::system_error(std::make_error_code(std::errc::invalid_argument),
-            "loading " + _name + " failed: EVMC ABI version mismatch"));
-    default:
-        BOOST_THROW_EXCEPTION(
-            std::system_error(std::error_code(static_cast<int>(ec), std::generic_category()),
-                "loading " + _name + " failed"));
-    }
+    t_evmcDll.reset();
 
-    g_evmcDll.reset(new EVMC{instance});
+    t_evmcDll = loadEvmcDll(_name);
+    g_evmcDllPath = _name;
 
-    cnote << "Loaded EVMC module: " << g_evmcDll->name() << " " << g_evmcDll->version() << " ("
+    cnote << "Loaded EVMC module: " << t_evmcDll->name() << " " << t_evmcDll->version() << " ("
           << _name << ")";
 }
 }  // namespace
@@ -189,9 +203,11 @@ VMPtr VMFactory::create(VMKind _kind)
     case VMKind::Interpreter:
         return {new EVMC{evmc_create_interpreter()}, default_delete};
     case VMKind::DLL:
-        assert(g_evmcDll != nullptr);
-        // Return "fake" owning pointer to global EVMC DLL VM.
-        return {g_evmcDll.get(), null_delete};
+        assert(!g_evmcDllPath.empty());
+        if (!t_evmcDll)
+            t_evmcDll = loadEvmcDll(g_evmcDllPath);
+        // Return "fake" owning pointer to the EVMC DLL VM of this thread.
+        return {t_evmcDll.get(), null_delete};
     case VMKind::Legacy:
     default:
         return {new LegacyVM, default_delete};
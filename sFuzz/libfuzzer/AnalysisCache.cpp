@@ -0,0 +1,53 @@
+#include <libdevcore/RLP.h>
+#include "AnalysisCache.h"
+
+namespace fuzzer {
+  h256 AnalysisCache::keyOf(const ContractInfo &contractInfo) {
+    RLPStream s(8);
+    s << ANALYSIS_CACHE_VERSION << contractInfo.bin << contractInfo.binRuntime
+      << contractInfo.srcmap << contractInfo.srcmapRuntime << contractInfo.source
+      << contractInfo.abiJson << contractInfo.constantFunctionSrcmap;
+    return sha3(s.out());
+  }
+
+  bool AnalysisCache::load(const string &path, const h256 &key, StaticAnalysis &analysis) {
+    auto data = contents(path);
+    if (data.empty()) return false;
+    try {
+      RLP rlp(data);
+      if (rlp.itemCountStrict() != 8) return false;
+      if (rlp[0].toInt<unsigned>() != ANALYSIS_CACHE_VERSION || rlp[1].toHash<h256>() != key) return false;
+      StaticAnalysis loaded;
+      loaded.key = key;
+      loaded.deploymentJumpis = rlp[2].toUnorderedSet<uint64_t>(RLP::Strict);
+      loaded.runtimeJumpis = rlp[3].toUnorderedSet<uint64_t>(RLP::Strict);
+      for (auto snippet : rlp[4].toVector<pair<uint64_t, string>>(RLP::Strict)) loaded.snippets.insert(snippet);
+      loaded.codeValues = rlp[5].toVector<bytes>(RLP::Strict);
+      loaded.selectors = rlp[6].toVector<bytes>(RLP::Strict);
+      for (auto eventHash : rlp[7].toVector<pair<string, string>>(RLP::Strict)) loaded.eventHashes.insert(eventHash);
+      analysis = loaded;
+      return true;
+    } catch (...) {
+      return false;
+    }
+  }
+
+  void AnalysisCache::save(const string &path, const StaticAnalysis &analysis) {
+    RLPStream s(8);
+    s << ANALYSIS_CACHE_VERSION << analysis.key;
+    /* RLPStream would narrow uint64_t to unsigned */
+    s.appendList(analysis.deploymentJumpis.size());
+    for (auto pc : analysis.deploymentJumpis) s << u256(pc);
+    s.appendList(analysis.runtimeJumpis.size());
+    for (auto pc : analysis.runtimeJumpis) s << u256(pc);
+    s.appendList(analysis.snippets.size());
+    for (auto &snippet : analysis.snippets) s.appendList(2) << u256(snippet.first) << snippet.second;
+    s << analysis.codeValues << analysis.selectors;
+    s.appendList(analysis.eventHashes.size());
+    for (auto &eventHash : analysis.eventHashes) s.appendList(2) << eventHash.first << eventHash.second;
+    try {
+      /* Written aside and renamed, so a parallel run never reads half a file */
+      writeFile(path, s.out(), true);
+    } catch (...) {}
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "Common.h"
+#include "Fuzzer.h"
+
+using namespace dev;
+using namespace std;
+
+namespace fuzzer {
+  /* Bump whenever the analysis or the layout below changes */
+  static const unsigned ANALYSIS_CACHE_VERSION = 1;
+  /* Everything computed from the main contract before its first execution */
+  struct StaticAnalysis {
+    h256 key;
+    unordered_set<uint64_t> deploymentJumpis;
+    unordered_set<uint64_t> runtimeJumpis;
+    unordered_map<uint64_t, string> snippets;
+    /* Push values of Dictionary::fromCode */
+    vector<bytes> codeValues;
+    /* Selectors of ContractABI::originalFds, empty for the constructor */
+    vector<bytes> selectors;
+    unordered_map<string, string> eventHashes;
+  };
+  /*
+   * RLP file next to the compiled json, keyed by the hash of every input of
+   * the analysis: bytecode, source maps, source, ABI and constant ranges
+   */
+  class AnalysisCache {
+    public:
+      static h256 keyOf(const ContractInfo &contractInfo);
+      /* False if the file is missing, malformed, of another version or of other inputs */
+      static bool load(const string &path, const h256 &key, StaticAnalysis &analysis);
+      static void save(const string &path, const StaticAnalysis &analysis);
+  };
+}
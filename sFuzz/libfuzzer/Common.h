@@ -11,6 +11,8 @@
 #include <libethereum/Block.h>
 #include <libethereum/ChainParams.h>
 #include <libethereum/Executive.h>
+#include <libethereum/ExtVM.h>
+#include <libethereum/FuzzState.h>
 #include <libethashseal/GenesisInfo.h>
 #include <libethereum/LastBlockHashesFace.h>
 #include <libethashseal/Ethash.h>
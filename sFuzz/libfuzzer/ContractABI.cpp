@@ -222,6 +222,37 @@ namespace fuzzer {
     }
   }
   
+  /*
+   * Encode the test case twice with every content byte replaced by a tag of
+   * its word and by the complement of that tag. Lengths, offsets and padding
+   * come out the same in both, bytes that differ carry the tag
+   */
+  vector<bytes> ContractABI::calldataSources(bytes data) {
+    auto encodeTagged = [&](bool complement) {
+      bytes tagged = data;
+      for (size_t i = 96; i < tagged.size(); i ++) {
+        byte tag = min<size_t>(i >> 5, 63) + 1;
+        tagged[i] = complement ? tag ^ 0xff : tag;
+      }
+      updateTestData(tagged);
+      vector<bytes> ret = {encodeConstructor()};
+      auto funcs = encodeFunctions();
+      ret.insert(ret.end(), funcs.begin(), funcs.end());
+      return ret;
+    };
+    auto tagged = encodeTagged(false);
+    auto complemented = encodeTagged(true);
+    vector<bytes> ret;
+    for (size_t i = 0; i < tagged.size(); i ++) {
+      bytes sources(tagged[i].size(), 0xff);
+      for (size_t j = 0; j < sources.size(); j ++) {
+        if (tagged[i][j] != complemented[i][j]) sources[j] = tagged[i][j] - 1;
+      }
+      ret.push_back(sources);
+    }
+    return ret;
+  }
+
   bytes ContractABI::randomTestcase(std::string filepath) {
     /*
      * Random value for ABI
@@ -430,7 +461,7 @@ namespace fuzzer {
     return ret;
   }
   
-  ContractABI::ContractABI(string abiJson) {
+  ContractABI::ContractABI(string abiJson, const vector<bytes> &selectors, const unordered_map<string, string> &eventHashes) {
     stringstream ss;
     ss << abiJson;
     pt::ptree root;
@@ -475,6 +506,14 @@ namespace fuzzer {
           this->events.push_back(EventDef(eventName, tds));
       }
     };
+    if (selectors.size() && selectors.size() == this->originalFds.size()) {
+      for (size_t i = 0; i < selectors.size(); i ++) this->originalFds[i].selector = selectors[i];
+      this->eventHashToSignatureMap = eventHashes;
+      return;
+    }
+    for (auto &fd : this->originalFds) {
+      if (fd.name != "") fd.selector = functionSelector(fd.name /* name */, fd.tds /* type defs */);
+    }
     for(auto event : this->events){
       std::string contract_api = functionapi(event.name,event.tds);
       bytes selector = eventSelector(event.name /* name */, event.tds /* type defs */);
@@ -674,7 +713,7 @@ std::string ContractABI::executionOrder() {
     
     for (auto fd : this->fds) {
       if (fd.name != "") {
-        bytes selector = functionSelector(fd.name /* name */, fd.tds /* type defs */);
+        bytes selector = fd.selector;
         bytes data = encodeTuple(fd.tds);
         selector.insert(selector.end(), data.begin(), data.end());
         ret.push_back(selector);
@@ -980,6 +1019,7 @@ std::string ContractABI::executionOrder() {
   
   void TypeDef::addValue(vector<vector<bytes>> vss) {
     if (this->dimensions.size() != 2) throw "Invalid dimension";;
+    this->dtss.clear();
     for (auto vs : vss) {
       vector<DataType> dts;
       for (auto v : vs) {
@@ -991,6 +1031,7 @@ std::string ContractABI::executionOrder() {
   
   void TypeDef::addValue(vector<bytes> vs) {
     if (this->dimensions.size() != 1) throw "Invalid dimension";
+    this->dts.clear();
     for (auto v : vs) {
       this->dts.push_back(DataType(v, this->padLeft, this->isDynamic));
     }
@@ -46,6 +46,8 @@ namespace fuzzer {
     string name;
     bool payable;
     vector<TypeDef> tds;
+    /* Computed once, functionSelector hashes the signature */
+    bytes selector;
     FuncDef(){};
     FuncDef(string name, vector<TypeDef> tds, bool payable);
   };
@@ -68,7 +70,8 @@ namespace fuzzer {
       vector<EventDef> events;
       std::unordered_map<std::string, std::string> eventHashToSignatureMap;
       ContractABI(){};
-      ContractABI(string abiJson);
+      /* Selectors and event hashes of an AnalysisCache are taken instead of hashing the signatures */
+      ContractABI(string abiJson, const vector<bytes> &selectors = {}, const unordered_map<string, string> &eventHashes = {});
       /* encoded ABI of contract constructor */
       bytes encodeConstructor();
       /* encoded ABI of contract functions */
@@ -77,6 +80,8 @@ namespace fuzzer {
       bytes randomTestcase(std::string filepath);
       /* Update then call encodeConstructor/encodeFunction to feed to evm */
       void updateTestData(bytes data);
+      /* Test case word each calldata byte comes from (0xff if none), constructor first */
+      vector<bytes> calldataSources(bytes data);
       //generate new function orders
       void reorderFunctions(std::string filepath);
       void setExecutionOrder(const std::vector<std::string>& order);
@@ -11,6 +11,14 @@ namespace fuzzer {
     extras.push_back(d);
   }
   
+  void Dictionary::fromValues(const vector<bytes> &values) {
+    for (auto &value : values) {
+      ExtraData d;
+      d.data = value;
+      extras.push_back(d);
+    }
+  }
+
   void Dictionary::fromCode(bytes code) {
     int pc = 0;
     int size = code.size();
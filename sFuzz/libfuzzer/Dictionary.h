@@ -16,6 +16,8 @@ namespace fuzzer {
       vector<ExtraData> extras;
       void fromCode(bytes code);
       void fromAddress(bytes address);
+      /* Values of an earlier fromCode, e.g. from an AnalysisCache */
+      void fromValues(const vector<bytes> &values);
       
       struct ContractFunction {
           std::string functionName; // 
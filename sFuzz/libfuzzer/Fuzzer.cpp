@@ -6,9 +6,10 @@
 #include "Dictionary.h"
 #include "Logger.h"
 #include "BytecodeBranch.h"
+#include "AnalysisCache.h"
+#include "Profile.h"
 #include <sstream>
-#include <algorithm> // for std::random_shuffle
-#include <random>    // for std::random_device and std::mt19937
+#include <algorithm> // for std::shuffle
 #include <chrono>    // for std::chrono
 
 using namespace dev;
@@ -18,7 +19,7 @@ using namespace fuzzer;
 namespace pt = boost::property_tree;
 
 /* Setup virgin byte to 255 */
-Fuzzer::Fuzzer(FuzzParam fuzzParam): fuzzParam(fuzzParam){
+Fuzzer::Fuzzer(FuzzParam fuzzParam): fuzzParam(fuzzParam), rng(fuzzParam.seed) {
   fill_n(fuzzStat.stageFinds, 32, 0);
 }
 
@@ -140,21 +141,17 @@ void Fuzzer::updateCurrentExecutionOrderScore(double increment) {
 }
 
 //从所有函数执行顺序中找到最好的那个
-std::vector<std::string> Fuzzer::findHighestScoreOrder() const {
+std::vector<std::string> Fuzzer::findHighestScoreOrder() {
     // 定义随机选择的概率（20% 随机选择，80% 选择最高得分）
     double randomSelectionProbability = 0.2;
 
     // 生成一个0到1之间的随机数
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
-    double randomValue = dis(gen);
+    double randomValue = rng.real();
 
     // 判断是否进行随机选择
     if (randomValue < randomSelectionProbability) {
         // 随机选择一个执行顺序
-        std::uniform_int_distribution<> indexDist(0, executionOrdersWithScores.size() - 1);
-        int randomIndex = indexDist(gen);
+        int randomIndex = rng.below(executionOrdersWithScores.size());
         return executionOrdersWithScores[randomIndex].first; // 返回随机选择的执行顺序
     } else {
         // 找到最高得分的执行顺序
@@ -179,7 +176,7 @@ double Fuzzer::runPreliminaryTests(TargetExecutive& executive,
     bytes data = executive.ca.randomTestcase(fuzzParam.filepath);
     
     FuzzItem curItem(data);
-    Mutation mutation(curItem, make_tuple(codeDict, addressDict),executive,fuzzParam.contractName);
+    Mutation mutation(curItem, make_tuple(codeDict, addressDict), executive, fuzzParam.contractName, rng);
     bool isfirstmutate = true;
 
     // 进行小范围的模糊测试
@@ -265,17 +262,13 @@ void Fuzzer::generateExecutionOrders(std::string filepath,const tuple<unordered_
         functionList.push_back(std::to_string(i)); // 函数的名称为 '1', '2', '3', ... 等
     }
 
-    // 使用随机生成器
-    std::random_device rd;
-    std::mt19937 g(rd());
-    
     
     auto start = timer.elapsed();
     // 根据传入的 numOrders 生成执行顺序
     for (int i = 0; i < numOrders; ++i) {
         if(randomOrder){
           order = functionList;  // 复制原始函数列表
-          std::shuffle(order.begin(), order.end(), g);    // 随机打乱顺序
+          std::shuffle(order.begin(), order.end(), rng);    // 随机打乱顺序
         }else{
           // 调用 generateExecutionOrder 生成新的执行顺序
           order = generateExecutionOrder(filepath, functionAPIs, existingOrders);
@@ -457,6 +450,10 @@ void Fuzzer::showStats(const Mutation &mutation, const tuple<unordered_set<uint6
   auto dictionary = padStr(dict1 + ", " + addrDict1, 30);
   auto hav1 = to_string(fuzzStat.stageFinds[STAGE_HAVOC]) + "/" + to_string(mutation.stageCycles[STAGE_HAVOC]);
   auto havoc = padStr(hav1, 30);
+  auto cmplog1 = to_string(fuzzStat.stageFinds[STAGE_CMPLOG]) + "/" + to_string(mutation.stageCycles[STAGE_CMPLOG]);
+  auto cmplog = padStr(cmplog1, 30);
+  auto gradient1 = to_string(fuzzStat.stageFinds[STAGE_GRADIENT]) + "/" + to_string(mutation.stageCycles[STAGE_GRADIENT]);
+  auto gradient = padStr(gradient1, 30);
   auto mutebylog1 = to_string(fuzzStat.stageFinds[STAGE_LOG]) + "/" + to_string(mutation.stageCycles[STAGE_LOG]);
   auto mutebylog = padStr(mutebylog1, 30);
   auto random1 = to_string(fuzzStat.stageFinds[STAGE_RANDOM]) + "/" + to_string(mutation.stageCycles[STAGE_RANDOM]);
@@ -469,8 +466,21 @@ void Fuzzer::showStats(const Mutation &mutation, const tuple<unordered_set<uint6
   auto maxdepthStr = padStr(to_string(fuzzStat.maxdepth), 5);
   auto exceptionCount = padStr(to_string(uniqExceptions.size()), 5);
   auto predicateSize = padStr(to_string(predicates.size()), 5);
+  auto hangs = padStr(to_string(uniqHangs.size()) + "/" + to_string(fuzzStat.totalHangs), 5);
+  auto sha3Memo = LegacyVM::sha3MemoStats();
+  auto sha3Hits = padStr(to_string(sha3Memo.second ? sha3Memo.first * 100 / sha3Memo.second : 0) + "%", 5);
   auto contract = mainContract();
   auto toResult = [](bool val) { return val ? "found" : "none "; };
+  /* Phase shares are of the top level phases, hook and oracle save are inside deploy and calls */
+  auto &prof = profile();
+  auto execs = max<uint64_t>(prof.events[EVENT_EXECS], 1);
+  uint64_t topCycles = 0;
+  for (auto phase : {PHASE_DECODE, PHASE_DEPLOY, PHASE_CALL, PHASE_BOOKKEEPING, PHASE_ANALYZE, PHASE_LLM}) topCycles += prof.cycles[phase];
+  auto phase = [&](Phase p) {
+    auto share = topCycles ? prof.cycles[p] * 100.0 / topCycles : 0;
+    return padStr(formatCount(share) + "%, " + formatCount((double) prof.cycles[p] / execs) + " cycles/exec", 30);
+  };
+  auto perExec = [&](Event e) { return padStr(formatCount((double) prof.events[e] / execs), 5); };
   printf(cGRN Bold "%sAFL Solidity v0.0.1 (%s)" cRST "\n", padStr("", 10).c_str(), fuzzParam.contractName.substr(0, 20).c_str());
   printf(bTL bV5 cGRN " processing time " cRST bV20 bV20 bV5 bV2 bV2 bV5 bV bTR "\n");
   printf(bH "      run time : %s " bH "\n", formatDuration(duration).data());
@@ -487,9 +497,20 @@ void Fuzzer::showStats(const Mutation &mutation, const tuple<unordered_set<uint6
   printf(bH " arithmetics : %s" bH "   max depth : %s" bH "\n", arithmetic.c_str(), maxdepthStr.c_str());
   printf(bH "  known ints : %s" bH " uniq except : %s" bH "\n", knownInts.c_str(), exceptionCount.c_str());
   printf(bH "  dictionary : %s" bH "  predicates : %s" bH "\n", dictionary.c_str(), predicateSize.c_str());
-  printf(bH "       havoc : %s" bH "               %s" bH "\n", havoc.c_str(), padStr("", 5).c_str());
+  printf(bH "       havoc : %s" bH "   sha3 hits : %s" bH "\n", havoc.c_str(), sha3Hits.c_str());
+  printf(bH "      cmplog : %s" bH "       hangs : %s" bH "\n", cmplog.c_str(), hangs.c_str());
+  printf(bH "    gradient : %s" bH "               %s" bH "\n", gradient.c_str(), padStr("", 5).c_str());
   printf(bH "   mutebylog : %s" bH "               %s" bH "\n", mutebylog.c_str(), padStr("", 5).c_str());
   printf(bH "      random : %s" bH "               %s" bH "\n", random.c_str(), padStr("", 5).c_str());
+  printf(bLTR bV5 cGRN " time per phase " cRST bV5 bV5 bV5 bV2 bV bV bV10 bV bCR bV cGRN " events / exec " cRST bV2 bV2 bRTR "\n");
+  printf(bH "  abi decode : %s" bH " instructions: %s" bH "\n", phase(PHASE_DECODE).c_str(), perExec(EVENT_INSTRUCTIONS).c_str());
+  printf(bH "      deploy : %s" bH "      hooked : %s" bH "\n", phase(PHASE_DEPLOY).c_str(), perExec(EVENT_HOOKED).c_str());
+  printf(bH "       calls : %s" bH "     sstores : %s" bH "\n", phase(PHASE_CALL).c_str(), perExec(EVENT_SSTORES).c_str());
+  printf(bH "        hook : %s" bH "nested calls : %s" bH "\n", phase(PHASE_HOOK).c_str(), perExec(EVENT_CALLS).c_str());
+  printf(bH " oracle save : %s" bH "   rollbacks : %s" bH "\n", phase(PHASE_ORACLE).c_str(), perExec(EVENT_ROLLBACKS).c_str());
+  printf(bH " bookkeeping : %s" bH "               %s" bH "\n", phase(PHASE_BOOKKEEPING).c_str(), padStr("", 5).c_str());
+  printf(bH "     analyze : %s" bH "               %s" bH "\n", phase(PHASE_ANALYZE).c_str(), padStr("", 5).c_str());
+  printf(bH "   llm waits : %s" bH "               %s" bH "\n", phase(PHASE_LLM).c_str(), padStr("", 5).c_str());
   printf(bLTR bV5 cGRN " oracle yields " cRST bV bV10 bV5 bV bTTR bV2 bV10 bV bBTR bV bV2 bV5 bV5 bV2 bV2 bV5 bV bRTR "\n");
   printf(bH "            gasless send : %s " bH " dangerous delegatecall : %s " bH "\n", toResult(vulnerabilities[GASLESS_SEND]), toResult(vulnerabilities[DELEGATE_CALL]));
   printf(bH "      exception disorder : %s " bH "         freezing ether : %s " bH "\n", toResult(vulnerabilities[EXCEPTION_DISORDER]), toResult(vulnerabilities[FREEZING]));
@@ -523,6 +544,8 @@ void Fuzzer::writeCoverageInfo(const std::string& contractName,
     root["state_functions_size"] = static_cast<Json::UInt64>(stateFdsSize);
     root["coverage"] = static_cast<Json::UInt64>(coverage);
     root["total_execs"] = static_cast<Json::UInt64>(fuzzStat.totalExecs);
+    root["total_hangs"] = static_cast<Json::UInt64>(fuzzStat.totalHangs);
+    root["unique_hangs"] = static_cast<Json::UInt64>(uniqHangs.size());
 
     // Vulnerability names corresponding to the `vulnerabilities` vector
     std::vector<std::string> vulnerabilityNames = {
@@ -546,6 +569,17 @@ void Fuzzer::writeCoverageInfo(const std::string& contractName,
     }
     root["vulnerabilities"] = vulnerabilitiesJson;
 
+    // Cycles per phase and event counts of this worker
+    Json::Value profileJson;
+    auto &prof = profile();
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        profileJson["cycles"][phaseName((Phase) i)] = static_cast<Json::UInt64>(prof.cycles[i]);
+    }
+    for (int i = 0; i < EVENT_COUNT; ++i) {
+        profileJson["events"][eventName((Event) i)] = static_cast<Json::UInt64>(prof.events[i]);
+    }
+    root["profile"] = profileJson;
+
     // Create the filename based on the contract name
     std::string filename = coverageDir + "/" + contractName + "_coverage.json";
 
@@ -560,15 +594,57 @@ void Fuzzer::writeCoverageInfo(const std::string& contractName,
     }
 }
 
+/* Hand the current numbers to the stats thread, cheap enough to run after every exec */
+void Fuzzer::writeStats(const Mutation &mutation, uint64_t totalPaths, bool last) {
+  if (fuzzParam.stats.empty()) return;
+  StatsSample sample;
+  sample.time = timer.elapsed();
+  sample.execs = fuzzStat.totalExecs;
+  sample.covered = tracebits.size();
+  sample.total = totalPaths;
+  sample.predicates = predicates.size();
+  sample.leaders = leaders.size();
+  sample.queueCycle = fuzzStat.queueCycle;
+  for (int i = 0; i < STATS_STAGES; i ++) {
+    sample.finds[i] = fuzzStat.stageFinds[i];
+    sample.cycles[i] = mutation.stageCycles[i];
+  }
+  sample.vulnerabilities = 0;
+  for (size_t i = 0; i < vulnerabilities.size(); i ++) {
+    if (vulnerabilities[i]) sample.vulnerabilities |= 1ull << i;
+  }
+  statsWriter.publish(sample, last);
+}
+
+/* Save the first test case hanging at each function and pc under hangs/ */
+void Fuzzer::saveHang(const string &hang, const bytes &data) {
+  auto hangDir = boost::filesystem::path("hangs") / fuzzParam.contractName;
+  boost::filesystem::create_directories(hangDir);
+  auto name = hang;
+  replace(name.begin(), name.end(), ':', '_');
+  ofstream file((hangDir / (name + ".txt")).string());
+  file << Logger::testFormat(data);
+}
+
 /* Save data if interest */
 FuzzItem Fuzzer::saveIfInterest(TargetExecutive& te, bytes data, uint64_t depth, const tuple<unordered_set<uint64_t>, unordered_set<uint64_t>>& validJumpis) {
+  /* Everything but the execution counts as bookkeeping, the timer adds the whole scope */
+  PhaseTimer phaseTimer(PHASE_BOOKKEEPING);
   auto revisedData = ContractABI::postprocessTestData(data);
   FuzzItem item(revisedData);
+  auto execStart = cycles();
   item.res = te.exec(revisedData, validJumpis);
+  profile().cycles[PHASE_BOOKKEEPING] -= cycles() - execStart;
   //std::cout << "the input data right now is :" << revisedData << std::endl;
   //std::cout << "log:" << item.res.log << std::endl;
   //Logger::debug(Logger::testFormat(item.data));
   fuzzStat.totalExecs ++;
+  /* A hang only covers part of its path, keep it out of the queue */
+  if (!item.res.hang.empty()) {
+    fuzzStat.totalHangs ++;
+    if (uniqHangs.insert(item.res.hang).second) saveHang(item.res.hang, revisedData);
+    return item;
+  }
   for (auto tracebit: item.res.tracebits) {
     if (!tracebits.count(tracebit)) {
       newBranchCoverd = true;
@@ -622,6 +698,13 @@ FuzzItem Fuzzer::saveIfInterest(TargetExecutive& te, bytes data, uint64_t depth,
 
 /* Stop fuzzing */
 void Fuzzer::stop() {
+  statsWriter.stop();
+  if (!fuzzParam.corpus.empty()) {
+    auto parent = boost::filesystem::path(fuzzParam.corpus).parent_path();
+    if (!parent.empty()) boost::filesystem::create_directories(parent);
+    ofstream corpus(fuzzParam.corpus);
+    for (auto &it : leaders) corpus << toHex(it.second.item.data) << endl;
+  }
   Logger::debug("== TEST ==");
   unordered_map<uint64_t, uint64_t> brs;
   for (auto it : leaders) {
@@ -653,21 +736,38 @@ void Fuzzer::stop() {
       }
     }
   }
-  exit(1);
+  throw Stopped();
 }
 
-/* Start fuzzing */
+/* Start fuzzing, returns once stop() ends the campaign */
 void Fuzzer::start() {
+  try {
+    fuzz();
+  } catch (const Stopped &) {}
+}
+
+void Fuzzer::fuzz() {
   auto mutatebylog_num = 20;
+  restartLLMReplay();
+  /* Counters are per thread, and a batch worker runs campaigns back to back */
+  profile() = Profile();
+  LegacyVM::resetSha3MemoStats();
+  fill(begin(Mutation::stageCycles), end(Mutation::stageCycles), 0);
   TargetContainer container;
   Dictionary codeDict, addressDict;
   unordered_set<u64> showSet;
-  //clear logger file content
-  Logger::clearLogs();
+  Logger::info("seed: " + to_string(fuzzParam.seed));
+  if (!fuzzParam.stats.empty()) statsWriter.start(fuzzParam.stats, fuzzParam.statsInterval);
   for (auto contractInfo : fuzzParam.contractInfo) {
     auto isAttacker = contractInfo.contractName.find(fuzzParam.attackerName) != string::npos;
     if (!contractInfo.isMain && !isAttacker) continue;
-    ContractABI ca(contractInfo.abiJson);
+    StaticAnalysis analysis;
+    auto cached = false;
+    if (contractInfo.isMain && !fuzzParam.analysisCache.empty()) {
+      analysis.key = AnalysisCache::keyOf(contractInfo);
+      cached = AnalysisCache::load(fuzzParam.analysisCache, analysis.key, analysis);
+    }
+    ContractABI ca(contractInfo.abiJson, analysis.selectors, analysis.eventHashes);
     auto bin = fromHex(contractInfo.bin);
     auto binRuntime = fromHex(contractInfo.binRuntime);
     // Accept only valid jumpis
@@ -687,14 +787,31 @@ void Fuzzer::start() {
       
       boost::filesystem::remove_all(contractName);
       //boost::filesystem::create_directory(contractName);
-      codeDict.fromCode(bin);
-      auto bytecodeBranch = BytecodeBranch(contractInfo);
-      auto validJumpis = bytecodeBranch.findValidJumpis();
-      snippets = bytecodeBranch.snippets;
+      pair<unordered_set<uint64_t>, unordered_set<uint64_t>> validJumpis;
+      if (cached) {
+        codeDict.fromValues(analysis.codeValues);
+        validJumpis = make_pair(analysis.deploymentJumpis, analysis.runtimeJumpis);
+        snippets = analysis.snippets;
+      } else {
+        codeDict.fromCode(bin);
+        auto bytecodeBranch = BytecodeBranch(contractInfo);
+        validJumpis = bytecodeBranch.findValidJumpis();
+        snippets = bytecodeBranch.snippets;
+        if (!fuzzParam.analysisCache.empty()) {
+          tie(analysis.deploymentJumpis, analysis.runtimeJumpis) = validJumpis;
+          analysis.snippets = snippets;
+          for (auto &extra : codeDict.extras) analysis.codeValues.push_back(extra.data);
+          for (auto &fd : ca.originalFds) analysis.selectors.push_back(fd.selector);
+          analysis.eventHashes = ca.eventHashToSignatureMap;
+          AnalysisCache::save(fuzzParam.analysisCache, analysis);
+        }
+      }
       if (!(get<0>(validJumpis).size() + get<1>(validJumpis).size())) {
         cout << "No valid jumpi" << endl;
         stop();
       }
+      /* Counted once, writeStats runs after every exec */
+      uint64_t totalBranches = (get<0>(validJumpis).size() + get<1>(validJumpis).size()) * 2;
       
       //在这里生成所有的函数执行顺序并进行小范围测试和打分
       
@@ -708,6 +825,7 @@ void Fuzzer::start() {
       stateFdsSize = ca.originalFds.size();
       
       auto executive = container.loadContract(bin, ca);
+      executive.trackTaint = fuzzParam.taint;
       double start = timer.elapsed();
       generateExecutionOrders(fuzzParam.filepath,validJumpis,codeDict, addressDict,executive,container);
       double end = timer.elapsed();
@@ -723,6 +841,7 @@ void Fuzzer::start() {
       //ca.reorderFunctions(fuzzParam.filepath);
       
       saveIfInterest(executive, executive.ca.randomTestcase(fuzzParam.filepath), 0, validJumpis);
+      for (auto &seed : fuzzParam.seeds) saveIfInterest(executive, seed, 0, validJumpis);
       int originHitCount = leaders.size();
       // No branch
       if (!originHitCount) {
@@ -734,7 +853,7 @@ void Fuzzer::start() {
       auto numUncoveredBranches = count_if(leaders.begin(), leaders.end(), fi);
       if (!numUncoveredBranches) {
         auto curItem = (*leaders.begin()).second.item;
-        Mutation mutation(curItem, make_tuple(codeDict, addressDict),executive,fuzzParam.contractName);
+        Mutation mutation(curItem, make_tuple(codeDict, addressDict), executive, fuzzParam.contractName, rng);
         mutateInfo = mutation.mutateInfo;
         vulnerabilities = container.analyze();
         switch (fuzzParam.reporter) {
@@ -752,13 +871,17 @@ void Fuzzer::start() {
             break;
           }
         }
+        writeStats(mutation, totalBranches, true);
         std::cout << "!numUncoveredBranches" << std::endl;
         stop();
       }
       
+      u64 lastEvaluationTime = totalTestTime;
+      u64 lastShowstatsTime = 0;
       // Jump to fuzz loop
       while (true) {
-        auto leaderIt = leaders.find(queues[fuzzStat.idx]);
+        auto branchId = queues[fuzzStat.idx];
+        auto leaderIt = leaders.find(branchId);
         auto curItem = leaderIt->second.item;
         auto comparisonValue = leaderIt->second.comparisonValue;
         if (comparisonValue != 0) {
@@ -768,7 +891,7 @@ void Fuzzer::start() {
           Logger::debug("Fuzzed \t\t\t\t " + to_string(curItem.fuzzedCount));
           Logger::debug(Logger::testFormat(curItem.data));
         }
-        Mutation mutation(curItem, make_tuple(codeDict, addressDict),executive,fuzzParam.contractName);
+        Mutation mutation(curItem, make_tuple(codeDict, addressDict), executive, fuzzParam.contractName, rng);
         mutation.mutateInfo = mutateInfo;
         
         vulnerabilities = container.analyze();
@@ -776,9 +899,8 @@ void Fuzzer::start() {
         
         auto save = [&](bytes data) {
           auto item = saveIfInterest(executive, data, curItem.depth, validJumpis);
+          writeStats(mutation, totalBranches);
           /* Show every one second */
-          static u64 lastEvaluationTime = totalTestTime;
-          static u64 lastShowstatsTime = 0;
           int duration = timer.elapsed();
           double duration1 = timer.elapsed();
           //writestats every seconds
@@ -863,6 +985,7 @@ void Fuzzer::start() {
 
             // Write coverage and vulnerabilities info to JSON
             writeCoverageInfo(contractName, tracebits, vulnerabilities, totalPaths);
+            writeStats(mutation, totalPaths, true);
             stop();
           }
           
@@ -872,8 +995,52 @@ void Fuzzer::start() {
         };
         // If it is uncovered branch
         if (comparisonValue != 0) {
+          /* Words reaching the branch condition, imprecise if they overflowed the mask */
+          auto taintIt = curItem.res.taints.find(branchId);
+          auto taint = taintIt == curItem.res.taints.end() ? 0 : taintIt->second;
+          bool preciseTaint = taint && !(taint & TAINT_OVERFLOW);
+          if (preciseTaint) mutation.setTaint(taint);
+          /* First visit of a leader runs the deterministic stages once, the
+           effector map built in bitflip 8/8 prunes the later ones */
+          if (!curItem.fuzzedCount) {
+            auto stage = [&](int stageId, function<void()> run) {
+              run();
+              Logger::debug(mutation.stageName);
+              fuzzStat.stageFinds[stageId] += leaders.size() - originHitCount;
+              originHitCount = leaders.size();
+            };
+            stage(STAGE_CMPLOG, [&]() { mutation.cmpLog(save); });
+            stage(STAGE_GRADIENT, [&]() { mutation.gradient(save, branchId); });
+            /* Flips only serve to find effective words, taint already did */
+            if (!preciseTaint) {
+              stage(STAGE_FLIP1, [&]() { mutation.singleWalkingBit(save); });
+              stage(STAGE_FLIP2, [&]() { mutation.twoWalkingBit(save); });
+              stage(STAGE_FLIP4, [&]() { mutation.fourWalkingBit(save); });
+              stage(STAGE_FLIP8, [&]() { mutation.singleWalkingByte(save); });
+              stage(STAGE_FLIP16, [&]() { mutation.twoWalkingByte(save); });
+              stage(STAGE_FLIP32, [&]() { mutation.fourWalkingByte(save); });
+            }
+            stage(STAGE_ARITH8, [&]() { mutation.singleArith(save); });
+            stage(STAGE_ARITH16, [&]() { mutation.twoArith(save); });
+            stage(STAGE_ARITH32, [&]() { mutation.fourArith(save); });
+            stage(STAGE_INTEREST8, [&]() { mutation.singleInterest(save); });
+            stage(STAGE_INTEREST16, [&]() { mutation.twoInterest(save); });
+            stage(STAGE_INTEREST32, [&]() { mutation.fourInterest(save); });
+            stage(STAGE_EXTRAS_UO, [&]() { mutation.overwriteWithDictionary(save); });
+            stage(STAGE_EXTRAS_AO, [&]() { mutation.overwriteWithAddressDictionary(save); });
+            /* Splice with other leaders then havoc the result */
+            vector<FuzzItem> items;
+            for (auto &leader : leaders) items.push_back(leader.second.item);
+            auto origin = mutation.curFuzzItem.data;
+            for (u32 i = 0; i < SPLICE_CYCLES; i ++) {
+              if (mutation.splice(items)) {
+                stage(STAGE_HAVOC, [&]() { mutation.havoc(save); });
+              }
+              mutation.curFuzzItem.data = origin;
+            }
+          }
           // if new branches are covered
-          if (newBranchCoverd) {
+          if (newBranchCoverd && !preciseTaint) {
             //update mutation stragegy
             Logger::debug("update mutate strategy");
             mutation.updateMutationStrategy(fuzzParam.filepath);
@@ -898,7 +1065,11 @@ void Fuzzer::start() {
             originHitCount = leaders.size();
           }  
         }
-        leaderIt->second.item.fuzzedCount += 1;
+        /* Stages insert leaders, look it up again and skip it if it was replaced */
+        leaderIt = leaders.find(branchId);
+        if (leaderIt != leaders.end() && leaderIt->second.item.data == curItem.data) {
+          leaderIt->second.item.fuzzedCount += 1;
+        }
         fuzzStat.idx = (fuzzStat.idx + 1) % queues.size();
         if (fuzzStat.idx == 0) {
             fuzzStat.queueCycle++;
@@ -922,6 +1093,7 @@ void Fuzzer::start() {
     
             // Write coverage and vulnerabilities info to JSON
             writeCoverageInfo(contractName, tracebits, vulnerabilities, totalPaths);
+            writeStats(mutation, totalPaths, true);
             stop(); // 或者 return; 根据您的逻辑选择
         }
       }
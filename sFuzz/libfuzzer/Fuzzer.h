@@ -1,5 +1,6 @@
 #pragma once
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <liboracle/Common.h>
 #include "ContractABI.h"
@@ -7,6 +8,7 @@
 #include "FuzzItem.h"
 #include "Mutation.h"
 #include "LLMhelper.h"
+#include "StatsWriter.h"
 #include <unordered_map> // 新增
 #include <map>           // 新增
 
@@ -38,12 +40,24 @@ namespace fuzzer {
     string filepath;
     string contractName;
     string folderName;
+    uint64_t seed = 0;
+    bool taint = false;
+    /* plot_data file written in the background every statsInterval seconds, none if empty */
+    string stats;
+    double statsInterval = 5;
+    /* Test cases run before fuzzing, e.g. the corpus of a contract with the same functions */
+    vector<bytes> seeds;
+    /* Leaders are written here on stop(), one hex test case per line, none if empty */
+    string corpus;
+    /* Static analysis of the main contract is read from or written to this file, none if empty */
+    string analysisCache;
   };
   struct FuzzStat {
     int idx = 0;
     uint64_t maxdepth = 0;
     bool clearScreen = false;
     int totalExecs = 0;
+    int totalHangs = 0;
     int queueCycle = 0;
     int stageFinds[32];
     double lastNewPath = 0;
@@ -80,24 +94,32 @@ namespace fuzzer {
     unordered_map<string, Leader> leaders;
     unordered_map<uint64_t, string> snippets;
     unordered_set<string> uniqExceptions;
+    unordered_set<string> uniqHangs;
     Timer timer;
     FuzzParam fuzzParam;
     FuzzStat fuzzStat;
-    void writeStats(const Mutation &mutation,const tuple<unordered_set<uint64_t>, unordered_set<uint64_t>> &validJumpis);
+    Random rng;
+    /* The last sample before stop() waits for the writer, others are dropped while it is busy */
+    void writeStats(const Mutation &mutation, uint64_t totalPaths, bool last = false);
     int calculateOrdersToGenerate(int numFunctions);
     double runPreliminaryTests(TargetExecutive& executive, const tuple<unordered_set<uint64_t>, unordered_set<uint64_t>>& validJumpis,TargetContainer& container,Dictionary codeDict, Dictionary addressDict);
     void insertExecutionOrder(const std::vector<std::string>& functionOrder, double score);
     void sortExecutionOrders();
     const std::vector<pair<std::vector<std::string>, double>>& getExecutionOrdersWithScores() const;
     double calculateAverageScore() const;
-    std::vector<std::string> findHighestScoreOrder() const;
+    std::vector<std::string> findHighestScoreOrder();
     void updateCurrentExecutionOrderScore(double increment);
     void removeLowestScoreOrders();
     void evaluateAndSelectOptimalOrder(TargetExecutive& executive,TargetContainer& container,const tuple<unordered_set<uint64_t>, unordered_set<uint64_t>>& validJumpis);
     FuzzItem saveIfInterest1(TargetExecutive& te, bytes data, uint64_t depth, const tuple<unordered_set<uint64_t>, unordered_set<uint64_t>>& validJumpis);
+    void saveHang(const string &hang, const bytes &data);
     void writeCoverageInfo(const std::string& contractName, const std::unordered_set<std::string>& tracebits, const std::vector<bool>& vulnerabilities, uint64_t totalPaths);
+    StatsWriter statsWriter;
     
     ContractInfo mainContract();
+    /* Thrown by stop() to unwind the fuzz loop back to start() */
+    struct Stopped {};
+    void fuzz();
     public:
       Fuzzer(FuzzParam fuzzParam);
       FuzzItem saveIfInterest(TargetExecutive& te, bytes data, uint64_t depth, const tuple<unordered_set<uint64_t>, unordered_set<uint64_t>> &validJumpis);
@@ -107,7 +129,9 @@ namespace fuzzer {
       void updateExceptions(unordered_set<string> uniqExceptions);
       void generateExecutionOrders(std::string filepath,const tuple<unordered_set<uint64_t>, unordered_set<uint64_t>>& validJumpis,Dictionary codeDict, Dictionary addressDict,TargetExecutive& executive,TargetContainer& container);
       
+      /* Fuzzes until the duration is over or nothing is left to cover, safe to run in parallel threads */
       void start();
+      /* Writes the results, only valid inside start() */
       void stop();
   };
 }
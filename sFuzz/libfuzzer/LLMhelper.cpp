@@ -7,12 +7,33 @@
 #include <exception>
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include <mutex>
+#include "LLMhelper.h"
+#include "Profile.h"
 
 // Cache structure
 std::unordered_map<std::string, std::string> contractCache;
+// Guards the cache and the record/replay state, campaigns of a batch share them
+static std::mutex llmLock;
 
 using json = nlohmann::json;
 
+// Selected LLM backend and its record file
+static LLMMode llmMode = LLM_LIVE;
+static std::string llmFile;
+// Replayed answers by prompt hash, and in the order they were recorded
+static std::unordered_map<std::string, std::string> replayAnswers;
+static std::vector<std::string> replaySequence;
+// Position in replaySequence of each campaign, so parallel campaigns do not shift each other
+static thread_local size_t replayCalls = 0;
+
+// curl_global_init is not thread safe, run it once for the whole process
+static void initCurl() {
+    static std::once_flag once;
+    std::call_once(once, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
 size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* response) {
     size_t totalSize = size * nmemb;
     response->append((char*)contents, totalSize);
@@ -48,6 +69,7 @@ std::string cleanJsonString(const std::string& responseStr) {
 }
 
 std::string readSolFileWithCache(const std::string& filePath) {
+    std::lock_guard<std::mutex> guard(llmLock);
     // Check if the file is already cached
     if (contractCache.find(filePath) != contractCache.end()) {
         return contractCache[filePath];  // Return cached contract content
@@ -91,7 +113,7 @@ std::string generateResponse_chatgpt(const std::string& user_input) {
     std::string content = "";
 
     // Initialize curl
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+    initCurl();
     curl = curl_easy_init();
 
     if(curl) {
@@ -145,7 +167,6 @@ std::string generateResponse_chatgpt(const std::string& user_input) {
         curl_easy_cleanup(curl);
     }
 
-    curl_global_cleanup();
     return content;
 }
 
@@ -178,7 +199,7 @@ std::string generateResponse_claude(const std::string& user_input) {
     })";
 
     // Initialize libcurl
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+    initCurl();
     curl = curl_easy_init();
 
     if (curl) {
@@ -221,10 +242,77 @@ std::string generateResponse_claude(const std::string& user_input) {
         curl_slist_free_all(headers);
     }
 
-    curl_global_cleanup();
     return content;
 }
 
+// FNV-1a, stable across compilers and runs unlike std::hash
+static std::string promptHash(const std::string& prompt) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : prompt) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::stringstream ss;
+    ss << std::hex << hash;
+    return ss.str();
+}
+
+void setLLMMode(LLMMode mode, const std::string& file) {
+    std::lock_guard<std::mutex> guard(llmLock);
+    llmMode = mode;
+    llmFile = file;
+    replayAnswers.clear();
+    replaySequence.clear();
+    replayCalls = 0;
+    if (mode != LLM_REPLAY) return;
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        std::cerr << "can't open LLM record " << file << ", every prompt gets an empty answer" << std::endl;
+        return;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        try {
+            auto entry = json::parse(line);
+            std::string answer = entry["response"];
+            replayAnswers[entry["hash"]] = answer;
+            replaySequence.push_back(answer);
+        } catch (const std::exception& e) {
+            std::cerr << "Error parsing LLM record: " << e.what() << std::endl;
+        }
+    }
+}
+
+void restartLLMReplay() {
+    replayCalls = 0;
+}
+
+std::string generateResponse(const std::string& user_input) {
+    fuzzer::PhaseTimer timer(fuzzer::PHASE_LLM);
+    auto hash = promptHash(user_input);
+    std::unique_lock<std::mutex> guard(llmLock);
+    auto call = replayCalls++;
+    if (llmMode == LLM_REPLAY) {
+        // Prompts embed execution logs, so a diverging run falls back to the
+        // answer recorded at the same position to stay deterministic
+        auto it = replayAnswers.find(hash);
+        if (it != replayAnswers.end()) return it->second;
+        if (call < replaySequence.size()) return replaySequence[call];
+        return "";
+    }
+    // Other campaigns keep going while this one waits for the API
+    guard.unlock();
+    std::string answer = generateResponse_claude(user_input);
+    if (llmMode == LLM_RECORD) {
+        guard.lock();
+        std::ofstream out(llmFile, std::ios::app);
+        json entry = {{"hash", hash}, {"response", answer}};
+        out << entry.dump() << std::endl;
+    }
+    return answer;
+}
+
 std::vector<std::string> extractFunctionOrder(const std::string& text) {
     std::vector<std::string> functionOrder;
 
@@ -304,7 +392,7 @@ std::vector<std::string> generateExecutionOrder(std::string& filepath, std::stri
   
     // std::cout << "prompt:" << prompt << std::endl;
   
-    std::string result = generateResponse_claude(prompt);
+    std::string result = generateResponse(prompt);
     
     // std::cout << "answer: " << result << std::endl;
     
@@ -344,7 +432,7 @@ std::string log_based_feedback(std::string& logs, std::string& filepath, const s
 
     // std::cout << "corpus generate prompt:" << generate_prompt<< std::endl;
         
-    std::string response = generateResponse_claude(generate_prompt);
+    std::string response = generateResponse(generate_prompt);
     response = cleanJsonString(response);
         
     // std::cout << "response:" << response<< std::endl;
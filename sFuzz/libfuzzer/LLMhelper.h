@@ -48,4 +48,17 @@ std::string generateResponse_claude(const std::string& user_input);
 //使用大语言模型返回随机
 std::string new_corpus_random(std::string& filepath, std::string& execution_order);
 
+// LLM backend: LIVE asks the API, RECORD asks it and appends every answer to a
+// file, REPLAY only reads answers back from that file and never opens a connection
+enum LLMMode { LLM_LIVE, LLM_RECORD, LLM_REPLAY };
+
+// Select the backend used by generateResponse, file is the JSONL record file
+void setLLMMode(LLMMode mode, const std::string& file);
+
+// Restart the replay fallback sequence of the calling thread, once per campaign
+void restartLLMReplay();
+
+// Answer a prompt through the selected backend
+std::string generateResponse(const std::string& user_input);
+
 #endif // CORPUS_GENERATE_H
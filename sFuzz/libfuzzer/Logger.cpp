@@ -1,3 +1,4 @@
+#include <mutex>
 #include "Logger.h"
 
 using namespace std;
@@ -6,20 +7,25 @@ namespace fuzzer {
   ofstream Logger::debugFile = ofstream("debug.txt", ios_base::app);
   ofstream Logger::infoFile = ofstream("info.txt", ios_base::app);
   bool Logger::enabled = true;
+  /* Campaigns of a batch log from several threads */
+  static mutex logLock;
 
   void Logger::debug(string str) {
     if (enabled) {
+      lock_guard<mutex> guard(logLock);
       debugFile << str << endl;
     }
   }
 
   void Logger::info(string str) {
     if (enabled) {
+      lock_guard<mutex> guard(logLock);
       infoFile << str << endl;
     }
   }
   
   void Logger::clearLogs() {
+    lock_guard<mutex> guard(logLock);
     // Close and reopen the log files in trunc mode to clear them
     debugFile.close();
     infoFile.close();
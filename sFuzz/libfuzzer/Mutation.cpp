@@ -6,15 +6,17 @@
 #include "Logger.h"
 #include <chrono>
 #include <iostream>
+#include <algorithm>
+#include <set>
 
 
 using namespace std;
 using namespace fuzzer;
 
-uint64_t Mutation::stageCycles[32] = {};
+thread_local uint64_t Mutation::stageCycles[32] = {};
 
-Mutation::Mutation(FuzzItem item, Dicts dicts, TargetExecutive& executive,std::string contractName)
-    : curFuzzItem(item), dicts(dicts), dataSize(item.data.size()), executive(executive),contractName(contractName) {
+Mutation::Mutation(FuzzItem item, Dicts dicts, TargetExecutive& executive, std::string contractName, Random &rng)
+    : curFuzzItem(item), dicts(dicts), dataSize(item.data.size()), executive(executive), contractName(contractName), rng(rng) {
     
     effCount = 0;
     eff = bytes(effALen(dataSize), 0);
@@ -45,6 +47,16 @@ void Mutation::initMutateInfo() {
 }
 
 
+/* Restrict the effector map and the log-based step to tainted words */
+void Mutation::setTaint(uint64_t taint) {
+  this->taint = taint;
+  effCount = 0;
+  for (u32 i = 0; i < eff.size(); i ++) {
+    eff[i] = (taint >> min(i, 63u)) & 1;
+    effCount += eff[i];
+  }
+}
+
 // 填充所有函数的参数位置
 void Mutation::populateParamPositions() {
     size_t position = 32 + 32; // 跳过 sender 和 block
@@ -411,15 +423,17 @@ void Mutation::mutate(OnMutateFunc cb,bool isfirstmutate) {
     
     //std::cout << "Old data: " << curFuzzItem.data << std::endl;
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
-    double randomValue = dis(gen);
+    double randomValue = rng.real();
 
     // 20%的几率使用 _havoc 生成的数据
     if (randomValue < 0.2) {
         //std::cout << "Using _havoc data for mutation" << std::endl;
         curFuzzItem.data = _havoc();  // _havoc 是提供随机变异数据的函数     
+    }else if (taint) {
+      /* Taint map says which words matter, no need for the LLM suggestions */
+      for (u32 i = 0; i < eff.size(); i ++) {
+        if (eff[i]) mutateParamAtPosition(i << EFF_MAP_SCALE2, min<u64>((i + 1) << EFF_MAP_SCALE2, dataSize), isfirstmutate);
+      }
     }else{
       // 遍历每个函数，检查其参数是否需要变异
       for (auto& fd : executive.ca.fds) {
@@ -468,15 +482,17 @@ bytes Mutation::_mutate(bool isfirstmutate) {
     
     //std::cout << "Old data: " << curFuzzItem.data << std::endl;
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
-    double randomValue = dis(gen);
+    double randomValue = rng.real();
 
     // 20%的几率使用 _havoc 生成的数据
     if (randomValue < 0.2) {
         //std::cout << "Using _havoc data for mutation" << std::endl;
         curFuzzItem.data = _havoc();  // _havoc 是提供随机变异数据的函数     
+    }else if (taint) {
+      /* Taint map says which words matter, no need for the LLM suggestions */
+      for (u32 i = 0; i < eff.size(); i ++) {
+        if (eff[i]) mutateParamAtPosition(i << EFF_MAP_SCALE2, min<u64>((i + 1) << EFF_MAP_SCALE2, dataSize), isfirstmutate);
+      }
     }else{
       // 遍历每个函数，检查其参数是否需要变异
       for (auto& fd : executive.ca.fds) {
@@ -849,43 +865,46 @@ void Mutation::fourInterest(OnMutateFunc cb) {
 void Mutation::overwriteWithDictionary(OnMutateFunc cb) {
   stageName = "dict (over)";
   auto dict = get<0>(dicts);
-  stageMax = dataSize * dict.extras.size();
+  u32 extrasCount = dict.extras.size();
+  stageMax = (dataSize >> 5) * extrasCount;
   stageCur = 0;
   /* Start fuzzing */
   byte *outBuf = curFuzzItem.data.data();
-  byte inBuf[curFuzzItem.data.size()];
-  memcpy(inBuf, outBuf, curFuzzItem.data.size());
-  u32 extrasCount = dict.extras.size();
+  byte inBuf[32];
   /*
    * In solidity - data block is 32 bytes then change to step = 32, not 1
-   * Size of extras is alway 32
+   * Extras are PUSH constants, they are placed right aligned and zero padded
+   * so that the word holds exactly the constant the contract compares with
    */
-  for (u32 i = 0; i < (u32)dataSize; i += 1) {
-    u32 lastLen = 0;
+  for (u32 i = 0; i + 32 <= (u32)dataSize; i += 32) {
+    /* Let's consult the effector map... */
+    if (!eff[effAPos(i)]) {
+      stageMax -= extrasCount;
+      continue;
+    }
+    memcpy(inBuf, outBuf + i, 32);
     for (u32 j = 0; j < extrasCount; j += 1) {
       byte *extrasBuf = dict.extras[j].data.data();
-      byte *effBuf = eff.data();
       u32 extrasLen = dict.extras[j].data.size();
+      u32 pad = 32 - extrasLen;
       /* Skip extras probabilistically if extras_cnt > MAX_DET_EXTRAS. Also
-       skip them if there's no room to insert the payload, if the token
-       is redundant, or if its entire span has no bytes set in the effector
-       map. */
+       skip them if they do not fit in a word or if the token is redundant. */
       if ((extrasCount > MAX_DET_EXTRAS
           && UR(extrasCount) > MAX_DET_EXTRAS)
-          || extrasLen > (dataSize - i)
-          || !memcmp(extrasBuf, outBuf + i, extrasLen)
-          || !memchr(effBuf + effAPos(i), 1, effSpanALen(i, extrasLen))
+          || extrasLen > 32
+          || (!memcmp(extrasBuf, inBuf + pad, extrasLen)
+              && all_of(inBuf, inBuf + pad, [](byte b) { return !b; }))
           ) {
         stageMax --;
         continue;
       }
-      lastLen = extrasLen;
-      memcpy(outBuf + i, extrasBuf, lastLen);
+      memset(outBuf + i, 0, pad);
+      memcpy(outBuf + i + pad, extrasBuf, extrasLen);
       cb(curFuzzItem.data);
       stageCur ++;
     }
     /* Restore all the clobbered memory. */
-    memcpy(outBuf + i, inBuf + i, lastLen);
+    memcpy(outBuf + i, inBuf, 32);
   }
   stageCycles[STAGE_EXTRAS_UO] += stageMax;
 }
@@ -893,16 +912,20 @@ void Mutation::overwriteWithDictionary(OnMutateFunc cb) {
 void Mutation::overwriteWithAddressDictionary(OnMutateFunc cb) {
   stageName = "address (over)";
   auto dict = get<1>(dicts);
-
-  stageMax = (dataSize / 32) * dict.extras.size();
+  u32 extrasCount = dict.extras.size();
+  stageMax = (dataSize >> 5) * extrasCount;
   stageCur = 0;
   /* Start fuzzing */
   byte *outBuf = curFuzzItem.data.data();
-  byte inBuf[curFuzzItem.data.size()];
-  memcpy(inBuf, outBuf, curFuzzItem.data.size());
-  u32 extrasCount = dict.extras.size();
+  byte inBuf[32];
   u32 extrasLen = 20;
-  for (u32 i = 0; i < (u32)dataSize; i += 32) {
+  for (u32 i = 0; i + 32 <= (u32)dataSize; i += 32) {
+    /* Let's consult the effector map... */
+    if (!eff[effAPos(i)]) {
+      stageMax -= extrasCount;
+      continue;
+    }
+    memcpy(inBuf, outBuf + i, 32);
     for (u32 j = 0; j < extrasCount; j += 1) {
       byte *extrasBuf = dict.extras[j].data.data();
       if (!memcmp(extrasBuf, outBuf + i + 12, extrasLen)) {
@@ -914,11 +937,173 @@ void Mutation::overwriteWithAddressDictionary(OnMutateFunc cb) {
       stageCur ++;
     }
     /* Restore all the clobbered memory. */
-    memcpy(outBuf + i, inBuf + i, 32);
+    memcpy(outBuf + i, inBuf, 32);
   }
   stageCycles[STAGE_EXTRAS_AO] += stageMax;
 }
 
+/*
+ * Input-to-state replacement: every operand seen by a comparison guarding a
+ * branch is searched in the test case under the encodings ContractABI uses,
+ * then swapped for the other operand (and +-1 of it for GT/LT)
+ */
+void Mutation::cmpLog(OnMutateFunc cb) {
+  stageName = "cmplog";
+  stageMax = 0;
+  stageCur = 0;
+  bytes &data = curFuzzItem.data;
+  set<pair<u256, u256>> replacements;
+  for (auto &it : curFuzzItem.res.cmpLog) {
+    for (auto &operands : it.second) {
+      if (operands.first == operands.second) continue;
+      replacements.insert(operands);
+      replacements.insert(make_pair(operands.second, operands.first));
+    }
+  }
+  /* repl and its neighbours, leaving out the ones that would wrap around */
+  auto neighbours = [](u256 repl) {
+    vector<u256> values{repl};
+    if (repl != numeric_limits<u256>::max()) values.push_back(repl + 1);
+    if (repl) values.push_back(repl - 1);
+    return values;
+  };
+  /* Write repl and its neighbours into len bytes at pos */
+  auto tryValues = [&](u32 pos, u32 len, u256 repl) {
+    auto orig = readBE(data, pos, len);
+    for (auto value : neighbours(repl)) {
+      stageMax ++;
+      if (value == orig || !writeBE(data, pos, len, value)) continue;
+      cb(data);
+      stageCur ++;
+    }
+    writeBE(data, pos, len, orig);
+  };
+  for (auto &replacement : replacements) {
+    u256 pattern = replacement.first;
+    u256 repl = replacement.second;
+    bool isAddress = !(pattern >> 160);
+    /* Sender balance (32 - 44), msg.value is sent as half of it */
+    if (readBE(data, 32, 12) / 2 == pattern) {
+      auto orig = readBE(data, 32, 12);
+      for (auto value : neighbours(repl)) {
+        stageMax ++;
+        if (!writeBE(data, 32, 12, value * 2)) continue;
+        cb(data);
+        stageCur ++;
+      }
+      writeBE(data, 32, 12, orig);
+    }
+    /* Sender address (44 - 64) */
+    if (isAddress && readBE(data, 44, 20) == pattern) tryValues(44, 20, repl);
+    /* Block number (64 - 72) and timestamp (72 - 80) */
+    if (readBE(data, 64, 8) == pattern) tryValues(64, 8, repl);
+    if (readBE(data, 72, 8) == pattern) tryValues(72, 8, repl);
+    /* Parameters, as whole words or as addresses truncated to 20 bytes */
+    for (u32 i = 96; i + 32 <= dataSize; i += 32) {
+      if (readBE(data, i, 32) == pattern) tryValues(i, 32, repl);
+      else if (isAddress && readBE(data, i + 12, 20) == pattern) tryValues(i + 12, 20, repl);
+    }
+  }
+  stageCycles[STAGE_CMPLOG] += stageCur;
+}
+
+/*
+ * Branch distance descent: for every numeric field, probe +-1 to find the
+ * direction that shrinks the distance of branchId, gallop with doubling steps
+ * then bisect the last step. Stops once the branch is taken
+ */
+void Mutation::gradient(OnMutateFunc cb, string branchId) {
+  stageName = "gradient";
+  stageMax = GRADIENT_MAX_EXECS;
+  stageCur = 0;
+  auto predicateIt = curFuzzItem.res.predicates.find(branchId);
+  if (predicateIt == curFuzzItem.res.predicates.end()) return;
+  u256 best = predicateIt->second;
+  bytes &data = curFuzzItem.data;
+  /* Distance after writing value, branch taken is 0, branch not reached is max */
+  auto distance = [&](u32 pos, u32 len, u256 value) {
+    writeBE(data, pos, len, value);
+    auto item = cb(data);
+    stageCur ++;
+    if (item.res.tracebits.count(branchId)) return u256(0);
+    auto it = item.res.predicates.find(branchId);
+    return it == item.res.predicates.end() ? ~u256(0) : it->second;
+  };
+  /* Sender balance, sender address, block number, timestamp, then parameters */
+  vector<pair<u32, u32>> fields = {{32, 12}, {44, 20}, {64, 8}, {72, 8}};
+  for (u32 i = 96; i + 32 <= dataSize; i += 32) fields.push_back(make_pair(i, 32));
+  for (auto &field : fields) {
+    u32 pos = field.first;
+    u32 len = field.second;
+    u256 maxValue = len == 32 ? ~u256(0) : (u256(1) << (len * 8)) - 1;
+    u256 x = readBE(data, pos, len);
+    /* Step x by delta in direction up, false if it would leave the field */
+    auto move = [&](bool up, u256 delta, u256 &out) {
+      if (up ? maxValue - x < delta : x < delta) return false;
+      out = up ? x + delta : x - delta;
+      return true;
+    };
+    u256 candidate;
+    int direction = 0;
+    for (bool up : {true, false}) {
+      if (stageCur >= stageMax || !best) break;
+      if (!move(up, 1, candidate)) continue;
+      u256 d = distance(pos, len, candidate);
+      if (d < best) {
+        best = d;
+        x = candidate;
+        direction = up ? 1 : -1;
+        break;
+      }
+    }
+    if (direction) {
+      u256 step = 2;
+      /* Gallop while the distance keeps shrinking */
+      while (stageCur < stageMax && best && move(direction > 0, step, candidate)) {
+        u256 d = distance(pos, len, candidate);
+        if (d >= best) break;
+        best = d;
+        x = candidate;
+        step <<= 1;
+      }
+      /* The optimum lies within the last step, bisect it */
+      while (stageCur < stageMax && best && step > 1) {
+        step >>= 1;
+        if (!move(direction > 0, step, candidate)) continue;
+        u256 d = distance(pos, len, candidate);
+        if (d < best) {
+          best = d;
+          x = candidate;
+        }
+      }
+    }
+    /* Keep the best value so later fields descend from it */
+    writeBE(data, pos, len, x);
+    if (stageCur >= stageMax || !best) break;
+  }
+  stageCycles[STAGE_GRADIENT] += stageCur;
+}
+
+/*
+ * Take the words after a random boundary from another test case of the same
+ * layout. The boundary is picked between the first and last differing word so
+ * that the result is neither of the two parents
+ */
+bool Mutation::splice(const vector<FuzzItem> &items) {
+  stageName = "splice";
+  if (items.size() <= 1 || dataSize <= 32) return false;
+  auto &target = items[UR(items.size())].data;
+  /* Different lengths mean different dynamic sizes, words would not line up */
+  if (target.size() != dataSize) return false;
+  s32 fLoc, lLoc;
+  bytes &data = curFuzzItem.data;
+  locateDiffs(data.data(), (byte *) target.data(), dataSize, &fLoc, &lLoc);
+  if (fLoc < 0 || effAPos(fLoc) == effAPos(lLoc)) return false;
+  u32 splitAt = (effAPos(fLoc) + 1 + UR(effAPos(lLoc) - effAPos(fLoc))) << EFF_MAP_SCALE2;
+  memcpy(data.data() + splitAt, target.data() + splitAt, dataSize - splitAt);
+  return true;
+}
+
 /*
  * TODO: If found more, do more havoc
  */
@@ -1042,7 +1227,7 @@ void Mutation::havoc(OnMutateFunc cb) {
            bytes (25%). */
           u32 copyFrom, copyTo, copyLen;
           if (dataSize < 2) break;
-          copyLen = chooseBlockLen(dataSize - 1);
+          copyLen = chooseBlockLen(dataSize - 1, rng);
           copyFrom = UR(dataSize - copyLen + 1);
           copyTo = UR(dataSize - copyLen + 1);
           if (UR(4)) {
@@ -1200,7 +1385,7 @@ bytes Mutation::_havoc() {
            bytes (25%). */
           u32 copyFrom, copyTo, copyLen;
           if (dataSize < 2) break;
-          copyLen = chooseBlockLen(dataSize - 1);
+          copyLen = chooseBlockLen(dataSize - 1, rng);
           copyFrom = UR(dataSize - copyLen + 1);
           copyTo = UR(dataSize - copyLen + 1);
           if (UR(4)) {
@@ -17,9 +17,13 @@ namespace fuzzer {
     Dicts dicts;
     TargetExecutive executive;
     std::string contractName;
+    Random &rng;
     uint64_t effCount = 0;
     bytes eff;
+    /* Words reaching the target branch, 0 if unknown */
+    uint64_t taint = 0;
     void flipbit(int pos);
+    u32 UR(u32 limit) { return rng.below(limit); }
     struct ParamPosition {
       size_t start;
       size_t end;
@@ -41,8 +45,9 @@ namespace fuzzer {
       std::vector<std::pair<size_t, size_t>> getMutateSections(const std::string& functionName);
       
       std::unordered_map<std::string, std::unordered_map<std::string, std::string>> mutateInfo;
-      Mutation(FuzzItem item, Dicts dicts,TargetExecutive& executive,std::string contractName);
+      Mutation(FuzzItem item, Dicts dicts, TargetExecutive& executive, std::string contractName, Random &rng);
       void initMutateInfo();
+      void setTaint(uint64_t taint);
       void updateMutationStrategy(std::string& file_path);
       std::unordered_map<std::string, std::unordered_map<std::string, std::string>> parseModelFeedback(const std::string& feedback);
       void mutateParamAtPosition(int start, int end,bool isfirstmutate);
@@ -54,7 +59,7 @@ namespace fuzzer {
       uint64_t stageMax = 0;
       uint64_t stageCur = 0;
       string stageName = "";
-      static uint64_t stageCycles[32];
+      static thread_local uint64_t stageCycles[32];
       void singleWalkingBit(OnMutateFunc cb);
       void twoWalkingBit(OnMutateFunc cb);
       void fourWalkingBit(OnMutateFunc cb);
@@ -69,9 +74,11 @@ namespace fuzzer {
       void fourInterest(OnMutateFunc cb);
       void overwriteWithAddressDictionary(OnMutateFunc cb);
       void overwriteWithDictionary(OnMutateFunc cb);
+      void cmpLog(OnMutateFunc cb);
+      void gradient(OnMutateFunc cb, string branchId);
       void random(OnMutateFunc cb,std::string& file_path,std::string execution_order);
       void havoc(OnMutateFunc cb);
-      bool splice(vector<FuzzItem> items);
+      bool splice(const vector<FuzzItem> &items);
       bytes _havoc();
       bytes test();
       
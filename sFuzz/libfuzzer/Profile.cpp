@@ -0,0 +1,40 @@
+#include "Profile.h"
+
+namespace fuzzer {
+  Profile& Profile::operator+=(const Profile &other) {
+    for (int i = 0; i < PHASE_COUNT; i ++) cycles[i] += other.cycles[i];
+    for (int i = 0; i < EVENT_COUNT; i ++) events[i] += other.events[i];
+    return *this;
+  }
+
+  Profile& profile() {
+    static thread_local Profile local;
+    return local;
+  }
+
+  string phaseName(Phase phase) {
+    switch (phase) {
+      case PHASE_DECODE: return "abi_decode";
+      case PHASE_DEPLOY: return "deploy";
+      case PHASE_CALL: return "calls";
+      case PHASE_HOOK: return "hook";
+      case PHASE_ORACLE: return "oracle_save";
+      case PHASE_BOOKKEEPING: return "save_if_interest";
+      case PHASE_ANALYZE: return "analyze";
+      case PHASE_LLM: return "llm";
+      default: return "";
+    }
+  }
+
+  string eventName(Event event) {
+    switch (event) {
+      case EVENT_EXECS: return "execs";
+      case EVENT_INSTRUCTIONS: return "instructions";
+      case EVENT_HOOKED: return "hooked";
+      case EVENT_SSTORES: return "sstores";
+      case EVENT_CALLS: return "nested_calls";
+      case EVENT_ROLLBACKS: return "rollbacks";
+      default: return "";
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+namespace fuzzer {
+  /* Where a worker spends its time, deploy and calls include the hook, which includes oracle saving */
+  enum Phase {
+    PHASE_DECODE,
+    PHASE_DEPLOY,
+    PHASE_CALL,
+    PHASE_HOOK,
+    PHASE_ORACLE,
+    PHASE_BOOKKEEPING,
+    PHASE_ANALYZE,
+    PHASE_LLM,
+    PHASE_COUNT
+  };
+  enum Event {
+    EVENT_EXECS,
+    EVENT_INSTRUCTIONS,
+    EVENT_HOOKED,
+    EVENT_SSTORES,
+    EVENT_CALLS,
+    EVENT_ROLLBACKS,
+    EVENT_COUNT
+  };
+  /* The hook runs for every instruction, so only one call in HOOK_SAMPLE is timed and scaled up */
+  static const uint64_t HOOK_SAMPLE = 16;
+  struct Profile {
+    uint64_t cycles[PHASE_COUNT] = {};
+    uint64_t events[EVENT_COUNT] = {};
+    Profile& operator+=(const Profile &other);
+  };
+  /* Counters of the calling worker */
+  Profile& profile();
+  string phaseName(Phase phase);
+  string eventName(Event event);
+  /* Time stamp counter where available, steady_clock nanoseconds elsewhere */
+  inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+  /* Adds the cycles of its scope to a phase */
+  class PhaseTimer {
+    Phase phase;
+    uint64_t start;
+    public:
+      PhaseTimer(Phase phase): phase(phase), start(cycles()) {}
+      ~PhaseTimer() { profile().cycles[phase] += cycles() - start; }
+  };
+}
@@ -0,0 +1,52 @@
+#include "Random.h"
+
+namespace fuzzer {
+  static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  Random::Random(uint64_t seed) {
+    this->seed(seed);
+  }
+
+  void Random::seed(uint64_t seed) {
+    /* splitmix64 expands the seed into the 256-bit state */
+    for (int i = 0; i < 4; i ++) {
+      uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      s[i] = z ^ (z >> 31);
+    }
+  }
+
+  uint64_t Random::next() {
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+  }
+
+  uint32_t Random::below(uint32_t limit) {
+    /* Lemire's multiply-shift, reject only the few values that cause bias */
+    uint64_t m = (uint64_t)(uint32_t)(next() >> 32) * limit;
+    uint32_t low = (uint32_t) m;
+    if (low < limit) {
+      uint32_t threshold = (uint32_t)(-limit) % limit;
+      while (low < threshold) {
+        m = (uint64_t)(uint32_t)(next() >> 32) * limit;
+        low = (uint32_t) m;
+      }
+    }
+    return (uint32_t)(m >> 32);
+  }
+
+  double Random::real() {
+    /* 53 high bits fill the double mantissa */
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+namespace fuzzer {
+  /*
+   * xoshiro256** engine, one instance per fuzzing worker
+   * Seeded through splitmix64 so that any 64-bit seed (including 0) gives
+   * a well mixed state and the whole campaign can be replayed from it
+   */
+  class Random {
+    uint64_t s[4];
+    public:
+      using result_type = uint64_t;
+      Random(uint64_t seed = 0);
+      void seed(uint64_t seed);
+      uint64_t next();
+      /* Uniform in [0, limit) without modulo bias, limit must be > 0 */
+      uint32_t below(uint32_t limit);
+      /* Uniform in [0, 1) */
+      double real();
+      /* UniformRandomBitGenerator so it can drive std::shuffle */
+      result_type operator()() { return next(); }
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+  };
+}
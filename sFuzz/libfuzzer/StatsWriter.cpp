@@ -0,0 +1,71 @@
+#include <chrono>
+#include <boost/filesystem.hpp>
+#include "StatsWriter.h"
+
+namespace fuzzer {
+  static const char* STAGE_NAMES[STATS_STAGES] = {
+    "flip1", "flip2", "flip4", "flip8", "flip16", "flip32",
+    "arith8", "arith16", "arith32",
+    "interest8", "interest16", "interest32",
+    "extras_uo", "log", "extras_ao", "havoc", "random", "cmplog", "gradient"
+  };
+
+  StatsWriter::~StatsWriter() {
+    stop();
+  }
+
+  void StatsWriter::start(const string &path, double interval) {
+    auto parent = boost::filesystem::path(path).parent_path();
+    if (!parent.empty()) boost::filesystem::create_directories(parent);
+    file.open(path, ios_base::app);
+    file << "# time, execs, execs_per_sec, covered, total, predicates, leaders, queue_cycle";
+    for (auto name : STAGE_NAMES) file << ", " << name << "_finds, " << name << "_cycles";
+    file << ", vulnerabilities" << endl;
+    this->interval = interval;
+    done = false;
+    worker = thread(&StatsWriter::run, this);
+  }
+
+  void StatsWriter::publish(const StatsSample &sample, bool wait) {
+    unique_lock<mutex> guard(lock, defer_lock);
+    if (wait) guard.lock();
+    else if (!guard.try_lock()) return;
+    latest = sample;
+    fresh = true;
+  }
+
+  void StatsWriter::stop() {
+    if (!worker.joinable()) return;
+    {
+      lock_guard<mutex> guard(lock);
+      done = true;
+    }
+    wake.notify_one();
+    worker.join();
+  }
+
+  void StatsWriter::run() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+      wake.wait_for(guard, chrono::duration<double>(interval), [this]() { return done; });
+      if (fresh) {
+        auto sample = latest;
+        fresh = false;
+        /* Publishers keep going while the line is formatted and written */
+        guard.unlock();
+        write(sample);
+        guard.lock();
+      }
+      if (done) break;
+    }
+  }
+
+  void StatsWriter::write(const StatsSample &sample) {
+    auto speed = sample.time > 0 ? (uint64_t) (sample.execs / sample.time) : 0;
+    file << sample.time << ", " << sample.execs << ", " << speed
+      << ", " << sample.covered << ", " << sample.total
+      << ", " << sample.predicates << ", " << sample.leaders << ", " << sample.queueCycle;
+    for (int i = 0; i < STATS_STAGES; i ++) file << ", " << sample.finds[i] << ", " << sample.cycles[i];
+    file << ", " << sample.vulnerabilities << endl;
+  }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Util.h"
+
+using namespace std;
+
+namespace fuzzer {
+  /* Stage ids of Util.h run from STAGE_FLIP1 to STAGE_GRADIENT */
+  static const int STATS_STAGES = STAGE_GRADIENT + 1;
+  struct StatsSample {
+    double time;
+    uint64_t execs;
+    uint64_t covered;
+    uint64_t total;
+    uint64_t predicates;
+    uint64_t leaders;
+    uint64_t queueCycle;
+    uint64_t finds[STATS_STAGES];
+    uint64_t cycles[STATS_STAGES];
+    /* Bit i is vulnerability i of the oracles */
+    uint64_t vulnerabilities;
+  };
+  /*
+   * Appends the latest published sample to a plot_data style file from its
+   * own thread every interval seconds. Each line is flushed, so a killed
+   * campaign keeps everything up to its last interval
+   */
+  class StatsWriter {
+    mutex lock;
+    condition_variable wake;
+    thread worker;
+    StatsSample latest;
+    bool fresh = false;
+    bool done = false;
+    double interval = 0;
+    ofstream file;
+    void run();
+    void write(const StatsSample &sample);
+    public:
+      ~StatsWriter();
+      void start(const string &path, double interval);
+      /* Unless wait, a sample is dropped if the writer is busy copying the last one */
+      void publish(const StatsSample &sample, bool wait = false);
+      /* Writes the last sample and joins the thread */
+      void stop();
+  };
+}
@@ -0,0 +1,207 @@
+#include "TaintTracker.h"
+
+namespace fuzzer {
+  /* Larger ranges are treated as out of bound */
+  static u64 MAX_RANGE = 1 << 16;
+
+  void TaintTracker::reset() {
+    frames.clear();
+    storage.clear();
+    lastCondition = 0;
+  }
+
+  void TaintTracker::beginTransaction(const bytes &sources) {
+    frames.clear();
+    txCalldata.clear();
+    for (auto source : sources) {
+      txCalldata.push_back(source == 0xff ? 0 : (Taint) 1 << source);
+    }
+  }
+
+  Taint TaintTracker::memoryRange(Frame &frame, u256 offset, u256 size) {
+    if (!size || offset > MAX_RANGE || size > MAX_RANGE) return 0;
+    Taint ret = 0;
+    u64 last = (u64)(offset + size - 1) >> 5;
+    for (u64 word = (u64) offset >> 5; word <= last; word ++) {
+      auto it = frame.memory.find(word);
+      if (it != frame.memory.end()) ret |= it->second;
+    }
+    return ret;
+  }
+
+  Taint TaintTracker::calldataRange(Frame &frame, u256 offset, u256 size) {
+    if (offset >= frame.calldata.size()) return 0;
+    Taint ret = 0;
+    u64 end = size > MAX_RANGE ? frame.calldata.size() : min((u64)(offset + size), (u64) frame.calldata.size());
+    for (u64 i = (u64) offset; i < end; i ++) ret |= frame.calldata[i];
+    return ret;
+  }
+
+  void TaintTracker::step(Instruction inst, u64 depth, const u256s &stack, ExtVMFace const* ext) {
+    /* Entering a call creates its frame, returning drops the callee's */
+    if (depth >= frames.size()) {
+      while (frames.size() <= depth) {
+        Frame frame;
+        if (frames.empty()) frame.calldata = txCalldata;
+        else frame.calldata = vector<Taint>(callSize, callTaint);
+        frames.push_back(frame);
+      }
+    } else if (depth + 1 < frames.size()) {
+      frames.resize(depth + 1);
+    }
+    auto &frame = frames[depth];
+    auto &labels = frame.stack;
+    /* Resync after anything the hook did not see, e.g. a failed instruction */
+    if (labels.size() != stack.size()) labels.resize(stack.size(), 0);
+    auto arg = [&](int i) { return stack[stack.size() - 1 - i]; };
+    auto pop = [&]() {
+      Taint label = labels.back();
+      labels.pop_back();
+      return label;
+    };
+    auto setMemory = [&](u256 offset, u256 size, function<Taint(u64)> labelOf) {
+      if (!size || offset > MAX_RANGE || size > MAX_RANGE) return;
+      u64 last = (u64)(offset + size - 1) >> 5;
+      for (u64 word = (u64) offset >> 5; word <= last; word ++) {
+        Taint label = labelOf(word);
+        if (label) frame.memory[word] = label;
+        else frame.memory.erase(word);
+      }
+    };
+    if (inst >= Instruction::DUP1 && inst <= Instruction::DUP16) {
+      int n = (int) inst - (int) Instruction::DUP1 + 1;
+      labels.push_back(labels[labels.size() - n]);
+      return;
+    }
+    if (inst >= Instruction::SWAP1 && inst <= Instruction::SWAP16) {
+      int n = (int) inst - (int) Instruction::SWAP1 + 1;
+      swap(labels.back(), labels[labels.size() - 1 - n]);
+      return;
+    }
+    switch (inst) {
+      case Instruction::CALLER:
+      case Instruction::ORIGIN:
+      case Instruction::CALLVALUE: {
+        labels.push_back(TAINT_SENDER);
+        break;
+      }
+      case Instruction::NUMBER:
+      case Instruction::TIMESTAMP: {
+        labels.push_back(TAINT_BLOCK);
+        break;
+      }
+      case Instruction::CALLDATASIZE: {
+        labels.push_back(TAINT_LENS);
+        break;
+      }
+      case Instruction::CALLDATALOAD: {
+        pop();
+        labels.push_back(calldataRange(frame, arg(0), 32));
+        break;
+      }
+      case Instruction::CALLDATACOPY: {
+        u256 memOffset = arg(0), dataOffset = arg(1), size = arg(2);
+        pop(); pop(); pop();
+        setMemory(memOffset, size, [&](u64 word) {
+          u256 from = word << 5;
+          from = from < memOffset ? dataOffset : dataOffset + from - memOffset;
+          return calldataRange(frame, from, 32);
+        });
+        break;
+      }
+      case Instruction::CODECOPY:
+      case Instruction::RETURNDATACOPY: {
+        u256 memOffset = arg(0), size = arg(2);
+        pop(); pop(); pop();
+        setMemory(memOffset, size, [](u64) { return (Taint) 0; });
+        break;
+      }
+      case Instruction::EXTCODECOPY: {
+        u256 memOffset = arg(1), size = arg(3);
+        pop(); pop(); pop(); pop();
+        setMemory(memOffset, size, [](u64) { return (Taint) 0; });
+        break;
+      }
+      case Instruction::MLOAD: {
+        u256 offset = arg(0);
+        pop();
+        labels.push_back(memoryRange(frame, offset, 32));
+        break;
+      }
+      case Instruction::MSTORE:
+      case Instruction::MSTORE8: {
+        u256 offset = arg(0);
+        pop();
+        Taint label = pop();
+        /* Unaligned or partial stores merge with what is already there */
+        bool whole = inst == Instruction::MSTORE && !(offset & 31);
+        u256 size = inst == Instruction::MSTORE ? 32 : 1;
+        setMemory(offset, size, [&](u64 word) {
+          if (whole) return label;
+          auto it = frame.memory.find(word);
+          return label | (it == frame.memory.end() ? 0 : it->second);
+        });
+        break;
+      }
+      case Instruction::SHA3: {
+        u256 offset = arg(0), size = arg(1);
+        Taint label = pop() | pop();
+        labels.push_back(label | memoryRange(frame, offset, size));
+        break;
+      }
+      case Instruction::SLOAD: {
+        /* Key label is kept, balances[msg.sender] depends on the sender */
+        auto key = make_pair(ext->myAddress, arg(0));
+        Taint label = pop();
+        auto it = storage.find(key);
+        labels.push_back(label | (it == storage.end() ? 0 : it->second));
+        break;
+      }
+      case Instruction::SSTORE: {
+        auto key = make_pair(ext->myAddress, arg(0));
+        pop();
+        Taint label = pop();
+        if (label) storage[key] = label;
+        else storage.erase(key);
+        break;
+      }
+      case Instruction::JUMPI:
+      case Instruction::JUMPCI: {
+        pop();
+        lastCondition = pop();
+        break;
+      }
+      case Instruction::CALL:
+      case Instruction::CALLCODE:
+      case Instruction::DELEGATECALL:
+      case Instruction::STATICCALL: {
+        bool hasValue = inst == Instruction::CALL || inst == Instruction::CALLCODE;
+        u256 inOffset = arg(hasValue ? 3 : 2), inSize = arg(hasValue ? 4 : 3);
+        callTaint = memoryRange(frame, inOffset, inSize);
+        callSize = inSize > MAX_RANGE ? 0 : (u64) inSize;
+        for (int i = 0; i < (hasValue ? 7 : 6); i ++) pop();
+        labels.push_back(0);
+        frames.resize(depth + 1);
+        break;
+      }
+      case Instruction::CREATE:
+      case Instruction::CREATE2: {
+        /* Init code is not calldata */
+        callTaint = 0;
+        callSize = 0;
+        for (int i = 0; i < (inst == Instruction::CREATE ? 3 : 4); i ++) pop();
+        labels.push_back(0);
+        frames.resize(depth + 1);
+        break;
+      }
+      default: {
+        /* Result depends on every operand */
+        auto info = instructionInfo(inst);
+        Taint label = 0;
+        for (int i = 0; i < info.args && !labels.empty(); i ++) label |= pop();
+        for (int i = 0; i < info.ret; i ++) labels.push_back(label);
+        break;
+      }
+    }
+  }
+}
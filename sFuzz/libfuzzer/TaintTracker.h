@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include <map>
+#include "Common.h"
+#include "Util.h"
+
+using namespace dev;
+using namespace eth;
+using namespace std;
+
+namespace fuzzer {
+  /* Bit i set: value depends on word i of the test case, words past 62 share bit 63 */
+  using Taint = uint64_t;
+  static Taint TAINT_LENS = 1 << 0;
+  static Taint TAINT_SENDER = 1 << 1;
+  static Taint TAINT_BLOCK = 1 << 2;
+  static Taint TAINT_OVERFLOW = 1ULL << 63;
+  /*
+   * Shadow execution of LegacyVM, fed from the OnOp hook before each
+   * instruction runs. Labels flow through the stack, memory (32 bytes
+   * granularity) and storage, lastCondition holds the label of the last
+   * JUMPI condition
+   */
+  class TaintTracker {
+    struct Frame {
+      vector<Taint> stack;
+      unordered_map<u64, Taint> memory;
+      vector<Taint> calldata;
+    };
+    vector<Frame> frames;
+    map<pair<Address, u256>, Taint> storage;
+    vector<Taint> txCalldata;
+    Taint callTaint = 0;
+    u64 callSize = 0;
+    Taint memoryRange(Frame &frame, u256 offset, u256 size);
+    Taint calldataRange(Frame &frame, u256 offset, u256 size);
+    public:
+      Taint lastCondition = 0;
+      /* New test case, storage labels are dropped */
+      void reset();
+      /* New top level call, sources from ContractABI::calldataSources */
+      void beginTransaction(const bytes &sources);
+      void step(Instruction inst, u64 depth, const u256s &stack, ExtVMFace const* ext);
+  };
+}
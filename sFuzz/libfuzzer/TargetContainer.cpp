@@ -18,10 +18,8 @@ namespace fuzzer {
   }
 
   TargetExecutive TargetContainer::loadContract(bytes code, ContractABI ca) {
-    if (baseAddress > CONTRACT_ADDRESS) {
-      cout << "> Currently does not allow to load more than 1 asset contract" << endl;
-      exit(0);
-    }
+    /* Thrown rather than exiting, so a batch only loses this contract */
+    if (baseAddress > CONTRACT_ADDRESS) throw runtime_error("Currently does not allow to load more than 1 asset contract");
     Address addr(baseAddress);
     TargetExecutive te(oracleFactory, program, addr, ca, code);
     baseAddress ++;
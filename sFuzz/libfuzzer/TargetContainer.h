@@ -2,6 +2,7 @@
 #include <vector>
 #include <map>
 #include "TargetExecutive.h"
+#include "Profile.h"
 
 using namespace dev;
 using namespace eth;
@@ -15,7 +16,10 @@ namespace fuzzer {
       OracleFactory *oracleFactory;
       TargetContainer();
       ~TargetContainer();
-      vector<bool> analyze() { return oracleFactory->analyze(); }
+      vector<bool> analyze() {
+        PhaseTimer timer(PHASE_ANALYZE);
+        return oracleFactory->analyze();
+      }
       TargetExecutive loadContract(bytes code, ContractABI ca);
   };
 }
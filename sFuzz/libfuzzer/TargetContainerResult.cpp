@@ -5,6 +5,8 @@ namespace fuzzer {
   TargetContainerResult::TargetContainerResult(
     unordered_set<string> tracebits,
     unordered_map<string, u256> predicates,
+    unordered_map<string, vector<pair<u256, u256>>> cmpLog,
+    unordered_map<string, uint64_t> taints,
     unordered_set<string> uniqExceptions,
     string cksum,
     string log
@@ -12,6 +14,8 @@ namespace fuzzer {
     this->tracebits = tracebits;
     this->cksum = cksum;
     this->predicates = predicates;
+    this->cmpLog = cmpLog;
+    this->taints = taints;
     this->uniqExceptions = uniqExceptions;
     this->log = log;
   }
@@ -14,6 +14,8 @@ namespace fuzzer {
     TargetContainerResult(
         unordered_set<string> tracebits,
         unordered_map<string, u256> predicates,
+        unordered_map<string, vector<pair<u256, u256>>> cmpLog,
+        unordered_map<string, uint64_t> taints,
         unordered_set<string> uniqExceptions,
         string cksum,
         string log
@@ -23,11 +25,17 @@ namespace fuzzer {
     unordered_set<string> tracebits;
     /* Save predicates */
     unordered_map<string, u256> predicates;
+    /* Operands of the last comparison before each recorded JUMPI, keyed like predicates by the branch not taken, covered or not */
+    unordered_map<string, vector<pair<u256, u256>>> cmpLog;
+    /* Test case words (bit per word) reaching the condition of each branch */
+    unordered_map<string, uint64_t> taints;
     /* Exception path */
     unordered_set<string> uniqExceptions;
     /* Contains checksum of tracebits */
     string cksum;
     /* Contains logs of execution*/
     string log;
+    /* Function and pc where the step limit was hit, empty if no call hung */
+    string hang;
   };
 }
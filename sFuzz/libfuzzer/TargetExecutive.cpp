@@ -1,41 +1,72 @@
 #include "TargetExecutive.h"
 #include "Logger.h"
 #include <libethcore/LogEntry.h>
-#include <sstream>  
+#include <sstream>
+#include <set>  
 
 namespace fuzzer {
   void TargetExecutive::deploy(bytes data, OnOpFunc onOp) {
     ca.updateTestData(data);
-    program->deploy(addr, bytes{code});
+    program->deploy(addr, code);
     program->setBalance(addr, DEFAULT_BALANCE);
     program->updateEnv(ca.decodeAccounts(), ca.decodeBlock());
+    LegacyVM::setStepLimit(STEP_LIMIT_MAX);
     program->invoke(addr, CONTRACT_CONSTRUCTOR, ca.encodeConstructor(), ca.isPayable(""), onOp);
   }
 
+  /* Allow a few times the most steps a call to the function took, so that only loops
+   * running far longer than anything seen so far are cut */
+  u64 TargetExecutive::stepLimit(const string &name) {
+    auto limit = max(maxSteps[name] * STEP_LIMIT_SCALE, STEP_LIMIT_MIN);
+    return min(max(limit, raisedLimits[name]), STEP_LIMIT_MAX);
+  }
+
+  /* Calls that finished within the limit are learned from. A call cut short below
+   * STEP_LIMIT_MAX doubles the limit of its function instead, so that a function
+   * whose normal path is long is not taken for a hang on every call */
+  bool TargetExecutive::learnSteps(const string &name) {
+    if (LegacyVM::stepLimitExceeded()) {
+      auto limit = stepLimit(name);
+      if (limit >= STEP_LIMIT_MAX) return true;
+      raisedLimits[name] = min(limit * 2, STEP_LIMIT_MAX);
+      return false;
+    }
+    auto &steps = maxSteps[name];
+    steps = max(steps, LegacyVM::steps());
+    return false;
+  }
+
   TargetContainerResult TargetExecutive::exec(bytes data, const tuple<unordered_set<uint64_t>, unordered_set<uint64_t>>& validJumpis) {
     /* Save all hit branches to trace_bits */
     Instruction prevInst;
     RecordParam recordParam;
     u256 lastCompValue = 0;
+    pair<u256, u256> lastCompOperands;
     u64 jumpDest1 = 0;
     u64 jumpDest2 = 0;
     unordered_set<string> uniqExceptions;
     unordered_set<string> tracebits;
     unordered_map<string, u256> predicates;
+    unordered_map<string, vector<pair<u256, u256>>> cmpLog;
+    unordered_map<string, Taint> taints;
+    string hang;
     vector<bytes> outputs;
     size_t savepoint = program->savepoint();
     
      // 字符串日志
     std::ostringstream logStream;  // 用于构建日志内容
     
-    OnOpFunc onOp = [&](u64, u64 pc, Instruction inst, bigint, bigint, bigint, VMFace const* _vm, ExtVMFace const* ext) {
-      auto vm = dynamic_cast<LegacyVM const*>(_vm);
+    Profile &prof = profile();
+    OnOpFunc onOp = [&](u64, u64 pc, Instruction inst, bigint, bigint, bigint, VMFace const* vm, ExtVMFace const* ext) {
+      bool timed = ++prof.events[EVENT_HOOKED] % HOOK_SAMPLE == 0;
+      uint64_t hookStart = timed ? cycles() : 0;
       /* Oracle analyze data */
       switch (inst) {
         case Instruction::CALL:
         case Instruction::CALLCODE:
         case Instruction::DELEGATECALL:
         case Instruction::STATICCALL: {
+          prof.events[EVENT_CALLS] ++;
           vector<u256>::size_type stackSize = vm->stack().size();
           u256 wei = (inst == Instruction::CALL || inst == Instruction::CALLCODE) ? vm->stack()[stackSize - 3] : 0;
           auto sizeOffset = (inst == Instruction::CALL || inst == Instruction::CALLCODE) ? (stackSize - 4) : (stackSize - 3);
@@ -54,6 +85,7 @@ namespace fuzzer {
           break;
         }
         case Instruction::SSTORE: {
+            prof.events[EVENT_SSTORES] ++;
             OpcodePayload payload;
             payload.pc = pc;
             payload.inst = inst;
@@ -117,6 +149,7 @@ namespace fuzzer {
             break;
           }
       }
+      if (timed) prof.cycles[PHASE_ORACLE] += (cycles() - hookStart) * HOOK_SAMPLE;
       /* Mutation analyzes data */
       switch (inst) {
         case Instruction::GT:
@@ -131,6 +164,7 @@ namespace fuzzer {
             /* calculate if command inside a function */
             u256 temp = left > right ? left - right : right - left;
             lastCompValue = temp + 1;
+            lastCompOperands = make_pair(left, right);
           }
           break;
         }
@@ -156,13 +190,33 @@ namespace fuzzer {
         u64 jumpDest = pc == jumpDest1 ? jumpDest2 : jumpDest1;
         branchId = to_string(recordParam.lastpc) + ":" + to_string(jumpDest);
         predicates[branchId] = lastCompValue;
+        if (trackTaint) taints[branchId] = taintTracker.lastCondition;
+        if (lastCompValue) {
+          auto &operands = cmpLog[branchId];
+          if (operands.size() < CMPLOG_MAX && find(operands.begin(), operands.end(), lastCompOperands) == operands.end()) {
+            operands.push_back(lastCompOperands);
+          }
+        }
       }
+      if (trackTaint) taintTracker.step(inst, ext->depth, vm->stack(), ext);
       prevInst = inst;
       recordParam.lastpc = pc;
+      if (timed) prof.cycles[PHASE_HOOK] += (cycles() - hookStart) * HOOK_SAMPLE;
     };
     /* Decode and call functions */
+    prof.events[EVENT_EXECS] ++;
+    auto phaseStart = cycles();
+    vector<bytes> sources;
+    if (trackTaint) {
+      sources = ca.calldataSources(data);
+      taintTracker.reset();
+      taintTracker.beginTransaction(sources[0]);
+    }
     ca.updateTestData(data);
     vector<bytes> funcs = ca.encodeFunctions();
+    auto decodeEnd = cycles();
+    prof.cycles[PHASE_DECODE] += decodeEnd - phaseStart;
+    phaseStart = decodeEnd;
     program->deploy(addr, code);
     program->setBalance(addr, DEFAULT_BALANCE);
     program->updateEnv(ca.decodeAccounts(), ca.decodeBlock());
@@ -177,8 +231,14 @@ namespace fuzzer {
     payload.caller = sender;
     payload.callee = addr;
     oracleFactory->save(OpcodeContext(0, payload));
-    auto res = program->invoke(addr, CONTRACT_CONSTRUCTOR, ca.encodeConstructor(), ca.isPayable(""), onOp);
-    if (res.excepted != TransactionException::None) {
+    LegacyVM::setStepLimit(stepLimit(""));
+    auto res = program->invoke(addr, CONTRACT_CONSTRUCTOR, ca.encodeConstructor(), ca.isPayable(""), hooked ? onOp : OnOpFunc());
+    prof.cycles[PHASE_DEPLOY] += cycles() - phaseStart;
+    prof.events[EVENT_INSTRUCTIONS] += LegacyVM::steps();
+    auto hung = learnSteps("");
+    if (hung) {
+      hang = "constructor:" + to_string(recordParam.lastpc);
+    } else if (res.excepted != TransactionException::None && res.excepted != TransactionException::StepLimitExceeded) {
       auto exceptionId = to_string(recordParam.lastpc);
       uniqExceptions.insert(exceptionId) ;
       /* Save Call Log */
@@ -200,7 +260,13 @@ namespace fuzzer {
       payload.caller = sender;
       payload.callee = addr;
       oracleFactory->save(OpcodeContext(0, payload));
-      res = program->invoke(addr, CONTRACT_FUNCTION, func, ca.isPayable(fd.name), onOp);
+      if (trackTaint) taintTracker.beginTransaction(sources[funcIdx + 1]);
+      LegacyVM::setStepLimit(stepLimit(fd.name));
+      phaseStart = cycles();
+      res = program->invoke(addr, CONTRACT_FUNCTION, func, ca.isPayable(fd.name), hooked ? onOp : OnOpFunc());
+      prof.cycles[PHASE_CALL] += cycles() - phaseStart;
+      prof.events[EVENT_INSTRUCTIONS] += LegacyVM::steps();
+      hung = learnSteps(fd.name);
       
       // 处理日志
       LogEntries logs = res.logs;
@@ -262,6 +328,7 @@ namespace fuzzer {
     		case TransactionException::OutOfGas: exception = "OutOfGas"; break;
     		case TransactionException::OutOfStack: exception = "OutOfStack"; break;
     		case TransactionException::StackUnderflow: exception = "StackUnderflow"; break;
+    		case TransactionException::StepLimitExceeded: exception = "StepLimitExceeded"; break;
         // 可根据需要添加其他异常类型
         default: exception = "Unknown"; break;
       }
@@ -271,7 +338,10 @@ namespace fuzzer {
       Logger::info("TransactionException:" + exception);
         
       outputs.push_back(res.output);
-      if (res.excepted != TransactionException::None) {
+      /* A call cut short below STEP_LIMIT_MAX is neither a hang nor an exception */
+      if (hung) {
+        if (hang.empty()) hang = fd.name + ":" + to_string(recordParam.lastpc);
+      } else if (res.excepted != TransactionException::None && res.excepted != TransactionException::StepLimitExceeded) {
         auto exceptionId = to_string(recordParam.lastpc);
         uniqExceptions.insert(exceptionId);
         /* Save Call Log */
@@ -283,8 +353,13 @@ namespace fuzzer {
     }
     /* Reset data before running new contract */
     program->rollback(savepoint);
+    prof.events[EVENT_ROLLBACKS] ++;
+    /* Sort so that the same path always gives the same checksum */
+    set<string> orderedTracebits(tracebits.begin(), tracebits.end());
     string cksum = "";
-    for (auto t : tracebits) cksum = cksum + t;
-    return TargetContainerResult(tracebits, predicates, uniqExceptions, cksum,logStream.str());
+    for (auto t : orderedTracebits) cksum = cksum + t + ",";
+    TargetContainerResult result(tracebits, predicates, cmpLog, taints, uniqExceptions, cksum,logStream.str());
+    result.hang = hang;
+    return result;
   }
 }
@@ -6,7 +6,9 @@
 #include "TargetProgram.h"
 #include "ContractABI.h"
 #include "TargetContainerResult.h"
+#include "TaintTracker.h"
 #include "Util.h"
+#include "Profile.h"
 
 using namespace dev;
 using namespace eth;
@@ -21,9 +23,21 @@ namespace fuzzer {
       TargetProgram *program;
       OracleFactory *oracleFactory;
       bytes code;
+      TaintTracker taintTracker;
+      /* Most instructions a call to each function ran without hanging */
+      unordered_map<string, u64> maxSteps;
+      /* Limit of each function after calls were cut short below STEP_LIMIT_MAX */
+      unordered_map<string, u64> raisedLimits;
+      u64 stepLimit(const string &name);
+      /* True if the call hung, i.e. ran out of STEP_LIMIT_MAX steps */
+      bool learnSteps(const string &name);
     public:
       ContractABI ca;
       Address addr;
+      /* Report the input words reaching each JUMPI condition */
+      bool trackTaint = false;
+      /* Run calls without the OnOp hook, results then carry no coverage or oracle data */
+      bool hooked = true;
       TargetExecutive(OracleFactory *oracleFactory, TargetProgram *program, Address addr, ContractABI ca, bytes code) {
         this->code = code;
         this->ca = ca;
@@ -5,23 +5,36 @@ using namespace dev;
 using namespace eth;
 
 namespace fuzzer {
-  TargetProgram::TargetProgram(): state(State(0)) {
-    Network networkName = Network::MainNetworkTest;
+  /* Parsed once per process and shared read-only by every program, so building a program only
+   * costs its state and env. Never freed, programs may outlive static destruction on exit() */
+  struct Chain {
     LastBlockHashes lastBlockHashes;
     BlockHeader blockHeader;
-    s64 maxGasLimit = ChainParams(genesisInfo(networkName))
-      .maxGasLimit.convert_to<s64>();
+    unique_ptr<SealEngineFace const> sealEngine;
+  };
+
+  static Chain const& chain() {
+    static Chain const *shared = [] {
+      Ethash::init();
+      NoProof::init();
+      ChainParams params(genesisInfo(Network::MainNetworkTest));
+      auto c = new Chain();
+      c->blockHeader.setGasLimit(params.maxGasLimit.convert_to<s64>());
+      c->blockHeader.setTimestamp(0);
+      c->blockHeader.setNumber(2675000);
+      c->sealEngine.reset(params.createSealEngine());
+      return c;
+    }();
+    return *shared;
+  }
+
+  TargetProgram::TargetProgram(): state(0) {
+    auto &shared = chain();
     gas = MAX_GAS;
-    timestamp = 0;
-    blockNumber = 2675000;
-    Ethash::init();
-    NoProof::init();
-    se = ChainParams(genesisInfo(networkName)).createSealEngine();
-    // add value
-    blockHeader.setGasLimit(maxGasLimit);
-    blockHeader.setTimestamp(timestamp);
-    blockHeader.setNumber(blockNumber);
-    envInfo = new EnvInfo(blockHeader, lastBlockHashes, 0);
+    timestamp = shared.blockHeader.timestamp();
+    blockNumber = shared.blockHeader.number();
+    se = shared.sealEngine.get();
+    envInfo = new EnvInfo(shared.blockHeader, shared.lastBlockHashes, 0);
   }
   
   void TargetProgram::setBalance(Address addr, u256 balance) {
@@ -32,9 +45,19 @@ namespace fuzzer {
     return state.balance(addr);
   }
 
-  void TargetProgram::deploy(Address addr, bytes code) {
+  SharedCode TargetProgram::share(unordered_map<Address, SharedCode> &codes, Address addr, const bytes &code) {
+    auto &shared = codes[addr];
+    if (!shared.code || *shared.code != code) {
+      shared.hash = sha3(code);
+      shared.code = state.intern(bytes{code}, shared.hash);
+    }
+    return shared;
+  }
+
+  void TargetProgram::deploy(Address addr, const bytes &code) {
+    auto shared = share(creationCodes, addr, code);
     state.clearStorage(addr);
-    state.setCode(addr, bytes{code});
+    state.setCode(addr, shared.code, shared.hash);
   }
     
   bytes TargetProgram::getCode(Address addr) {
@@ -44,11 +67,29 @@ namespace fuzzer {
   ExecutionResult TargetProgram::invoke(Address addr, ContractCall type, bytes data, bool payable, OnOpFunc onOp) {
     switch (type) {
       case CONTRACT_CONSTRUCTOR: {
-        bytes code = state.code(addr);
-        code.insert(code.end(), data.begin(), data.end());
-        state.setCode(addr, bytes{code});
+        /*
+         * Constructor arguments follow the creation code set by deploy(). The joined code is
+         * only built again when the creation code or the arguments change
+         */
+        auto code = creationCodes[addr];
+        if (!data.empty()) {
+          auto &joined = constructorCodes[addr];
+          if (joined.creation != code.code || joined.args != data) {
+            bytes bin;
+            bin.reserve(code.code->size() + data.size());
+            bin.insert(bin.end(), code.code->begin(), code.code->end());
+            bin.insert(bin.end(), data.begin(), data.end());
+            joined.creation = code.code;
+            joined.args = data;
+            joined.code.hash = sha3(bin);
+            joined.code.code = state.intern(move(bin), joined.code.hash);
+          }
+          code = joined.code;
+        }
+        state.setCode(addr, code.code, code.hash);
         ExecutionResult res = invoke(addr, data, payable, onOp);
-        state.setCode(addr, bytes{res.output});
+        auto runtime = share(runtimeCodes, addr, res.output);
+        state.setCode(addr, runtime.code, runtime.hash);
         return res;
       }
       case CONTRACT_FUNCTION: {
@@ -64,14 +105,10 @@ namespace fuzzer {
     ExecutionResult res;
     Address senderAddr(sender);
     u256 value = payable ? state.balance(sender) / 2 : 0;
-    u256 gasPrice = 0;
-    Transaction t = Transaction(value, gasPrice, gas, data, state.getNonce(sender));
-    t.forceSender(senderAddr);
     Executive executive(state, *envInfo, *se);
     executive.setResultRecipient(res);
-    executive.initialize(t);
-    LegacyVM::payload = data;
-    executive.call(addr, senderAddr, value, gasPrice, &data, gas);
+    ExtVM::payload = data;
+    executive.directCall(addr, senderAddr, value, &data, gas);
     executive.updateBlock(blockNumber, timestamp);
     executive.go(onOp);
     executive.finalize();
@@ -96,12 +133,11 @@ namespace fuzzer {
   }
 
   size_t TargetProgram::savepoint() {
-    return state.savepoint();
+    return state.baseSavepoint();
   }
   
   TargetProgram::~TargetProgram() {
     delete envInfo;
-    delete se;
   }
 }
 
@@ -10,15 +10,30 @@ using namespace std;
 
 namespace fuzzer {
   enum ContractCall { CONTRACT_CONSTRUCTOR, CONTRACT_FUNCTION };
+  struct SharedCode {
+    shared_ptr<bytes const> code;
+    h256 hash;
+  };
+  /* Creation code followed by constructor arguments, built from this creation buffer and args */
+  struct ConstructorCode {
+    shared_ptr<bytes const> creation;
+    bytes args;
+    SharedCode code;
+  };
   class TargetProgram {
     private:
-      State state;
+      FuzzState state;
       u256 gas;
       int64_t timestamp;
       int64_t blockNumber;
       u160 sender;
       EnvInfo *envInfo;
-      SealEngineFace *se;
+      SealEngineFace const *se;
+      /* Code last set at each address, reused while the bytes do not change */
+      unordered_map<Address, SharedCode> creationCodes;
+      unordered_map<Address, SharedCode> runtimeCodes;
+      unordered_map<Address, ConstructorCode> constructorCodes;
+      SharedCode share(unordered_map<Address, SharedCode> &codes, Address addr, const bytes &code);
       ExecutionResult invoke(Address addr, bytes data, bool payable, OnOpFunc onOp);
     public:
       TargetProgram();
@@ -27,7 +42,7 @@ namespace fuzzer {
       bytes getCode(Address addr);
       map<h256, pair<u256, u256>> storage(Address const& addr);
       void setBalance(Address addr, u256 balance);
-      void deploy(Address addr, bytes code);
+      void deploy(Address addr, const bytes &code);
       void updateEnv(Accounts accounts, FakeBlock block);
       unordered_map<Address, u256> addresses();
       size_t savepoint();
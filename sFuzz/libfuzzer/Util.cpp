@@ -6,10 +6,6 @@ namespace dev {
 }
 
 namespace fuzzer {
-  u32 UR(u32 limit) {
-    return random() % limit;
-  }
-
   int effAPos(int p) {
     return p >> EFF_MAP_SCALE2;
   }
@@ -131,6 +127,21 @@ namespace fuzzer {
     return false;
   }
 
+  u256 readBE(const bytes &data, u32 pos, u32 len) {
+    u256 value = 0;
+    for (u32 i = 0; i < len; i ++) value = (value << 8) | data[pos + i];
+    return value;
+  }
+
+  bool writeBE(bytes &data, u32 pos, u32 len, u256 value) {
+    if (len < 32 && (value >> (len * 8))) return false;
+    for (u32 i = len; i > 0; i --) {
+      data[pos + i - 1] = (u8)(value & 0xff);
+      value >>= 8;
+    }
+    return true;
+  }
+
   u16 swap16(u16 x) {
     return x << 8 | x >> 8;
   }
@@ -139,11 +150,11 @@ namespace fuzzer {
     return x << 24 | x >> 24 | ((x << 8) & 0x00FF0000) | ((x >> 8) & 0x0000FF00);
   }
 
-  u32 chooseBlockLen(u32 limit) {
+  u32 chooseBlockLen(u32 limit, Random &rng) {
     /* Delete at most: 1/4 */
     int maxFactor = limit / (4 * 32);
     if (!maxFactor) return 0;
-    return (UR(maxFactor) + 1) * 32;
+    return (rng.below(maxFactor) + 1) * 32;
   }
 
   void locateDiffs(byte* ptr1, byte* ptr2, u32 len, s32* first, s32* last) {
@@ -178,6 +189,18 @@ namespace fuzzer {
     return padStr(ret.str(), 48);
   }
 
+  string formatCount(double count) {
+    const char *units[] = {"", "k", "M", "G", "T"};
+    int unit = 0;
+    while (count >= 999.5 && unit < 4) {
+      count /= 1000;
+      unit ++;
+    }
+    char buf[16];
+    snprintf(buf, sizeof(buf), count < 99.95 && (unit || count != (uint64_t) count) ? "%.1f%s" : "%.0f%s", count, units[unit]);
+    return buf;
+  }
+
   string padStr(string str, int len) {
     while ((int)str.size() < len) str += " ";
     return str;
@@ -2,6 +2,7 @@
 #include <vector>
 #include <fstream>
 #include "Common.h"
+#include "Random.h"
 
 #define unlikely(_x)  __builtin_expect(!!(_x), 0)
 #define likely(_x)   __builtin_expect(!!(_x), 1)
@@ -55,33 +56,40 @@ namespace fuzzer {
 
   static u32 SPLICE_CYCLES = 15;
   static u32 MAX_DET_EXTRAS = 200;
-  static int STAGE_FLIP1 = 0;
-  static int STAGE_FLIP2 = 1;
-  static int STAGE_FLIP4 = 2;
-  static int STAGE_FLIP8 = 3;
-  static int STAGE_FLIP16 = 4;
-  static int STAGE_FLIP32 = 5;
-  static int STAGE_ARITH8 = 6;
-  static int STAGE_ARITH16 = 7;
-  static int STAGE_ARITH32 = 8;
-  static int STAGE_INTEREST8 = 9;
-  static int STAGE_INTEREST16 = 10;
-  static int STAGE_INTEREST32 = 11;
-  static int STAGE_EXTRAS_UO = 12;
-  static int STAGE_EXTRAS_AO = 14;
-  static int STAGE_HAVOC = 15;
-  static int STAGE_RANDOM = 16;
+  static const int STAGE_FLIP1 = 0;
+  static const int STAGE_FLIP2 = 1;
+  static const int STAGE_FLIP4 = 2;
+  static const int STAGE_FLIP8 = 3;
+  static const int STAGE_FLIP16 = 4;
+  static const int STAGE_FLIP32 = 5;
+  static const int STAGE_ARITH8 = 6;
+  static const int STAGE_ARITH16 = 7;
+  static const int STAGE_ARITH32 = 8;
+  static const int STAGE_INTEREST8 = 9;
+  static const int STAGE_INTEREST16 = 10;
+  static const int STAGE_INTEREST32 = 11;
+  static const int STAGE_EXTRAS_UO = 12;
+  static const int STAGE_EXTRAS_AO = 14;
+  static const int STAGE_HAVOC = 15;
+  static const int STAGE_RANDOM = 16;
+  static const int STAGE_CMPLOG = 17;
+  static const int STAGE_GRADIENT = 18;
   static int HAVOC_STACK_POW2 = 7;
   static int HAVOC_MIN = 16;
-  static int EFF_MAP_SCALE2 = 4; // 32 bytes block
+  static int EFF_MAP_SCALE2 = 5; // 32 bytes block, one ABI word
   static int ARITH_MAX = 35;
   static int EFF_MAX_PERC = 90;
-  static int STAGE_LOG = 13;
+  static const int STAGE_LOG = 13;
+  static u32 CMPLOG_MAX = 8; // operand pairs kept per branch
+  static u32 GRADIENT_MAX_EXECS = 256; // exec budget of one descent
+  static u64 STEP_LIMIT_MIN = 100000; // instructions a call may always run
+  static u64 STEP_LIMIT_MAX = 10000000; // instructions after which a call always hangs
+  static u64 STEP_LIMIT_SCALE = 8; // limit over the most steps a normal call took
   static s8 INTERESTING_8[] = { -128, -1, 0, 1, 16, 32, 64, 100, 127};
   static s16 INTERESTING_16[] = {-128, -1, 0, 1, 16, 32, 64, 100, 127, -32768, -129, 128, 255, 256, 512, 1000, 1024, 4096, 32767};
   static s32 INTERESTING_32[] = {-128, -1, 0, 1, 16, 32, 64, 100, 127, -32768, -129, 128, 255, 256, 512, 1000, 1024, 4096, 32767, -2147483648, -100663046, -32769, 32768, 65535, 65536, 100663045, 2147483647};
   
-  /* Scale position: 1 efficient block contains 8 bytes */
+  /* Scale position: 1 efficient block contains 32 bytes */
   int effAPos(int p);
   /* Divide with remainder */
   int effRem(int x);
@@ -92,8 +100,11 @@ namespace fuzzer {
   bool couldBeBitflip(u32 xorVal);
   bool couldBeArith(u32 oldVal, u32 newVal, u8 len);
   bool couldBeInterest(u32 oldVal, u32 newVal, u8 blen, u8 checkLe);
-  u32 chooseBlockLen(u32 limit);
-  u32 UR(u32 limit);
+  u32 chooseBlockLen(u32 limit, Random &rng);
+  /* Read len bytes at pos as a big-endian number */
+  u256 readBE(const bytes &data, u32 pos, u32 len);
+  /* Write value as len big-endian bytes at pos, false if it does not fit */
+  bool writeBE(bytes &data, u32 pos, u32 len, u256 value);
   /* Swap 2 bytes */
   u16 swap16(u16 x);
   /* Swap 4 bytes */
@@ -101,6 +112,8 @@ namespace fuzzer {
   /* Locate differents */
   void locateDiffs(byte* ptr1, byte* ptr2, u32 len, s32* first, s32* last);
   string formatDuration(int duration);
+  /* At most 5 characters, 1234567 is 1.2M */
+  string formatCount(double count);
   string padStr(string str, int len);
   /* Data struct */
   struct ExtraData {
@@ -32,4 +32,6 @@ class OracleFactory {
     void finalize();
     void save(OpcodeContext ctx);
     vector<bool> analyze();
+    /* Opcodes saved by each call finalized since the last analyze() */
+    const MultipleFunction &events() const { return functions; }
 };
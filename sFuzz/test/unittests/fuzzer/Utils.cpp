@@ -0,0 +1,181 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/// @file
+/// Helpers of the fuzzer executable.
+
+#include <test/tools/libtesteth/TestHelper.h>
+#include <fuzzer/Utils.h>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+using namespace std;
+using namespace dev;
+namespace pt = boost::property_tree;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+/// solc 0.4 trailer: {"bzzr0": <32 bytes>}.
+string const c_swarmMetadata =
+    "a165627a7a72305820" + string(64, 'a') + "0029";
+/// solc 0.6 trailer: {"ipfs": <34 bytes>, "solc": 0.6.12}.
+string const c_ipfsMetadata =
+    "a264697066735822" + string(68, 'b') + "64736f6c634300060c0033";
+
+/// Runtime returning nothing, deployed by the constructors below.
+string const c_runtime = "6080604052600080fd";
+/// Constructors copying c_runtime, the second one also stores 1 at slot 0.
+string const c_constructor = "6009600c60003960096000f3";
+string const c_storingConstructor = "60016000556009601160003960096000f3";
+
+string const c_abi =
+    R"([{"constant":false,"inputs":[{"name":"x","type":"uint256"}],"name":"f","outputs":[],)"
+    R"("payable":false,"stateMutability":"nonpayable","type":"function"}])";
+
+ContractInfo contract(string const& _constructor, string const& _metadata)
+{
+    ContractInfo info;
+    info.abiJson = c_abi;
+    info.bin = _constructor + c_runtime + _metadata;
+    info.binRuntime = c_runtime + _metadata;
+    return info;
+}
+
+/// The property tree traversal parseJson used before the streaming reader.
+ContractInfo parseJsonTree(string const& _jsonFile, string const& _contractName)
+{
+    pt::ptree root;
+    pt::read_json(_jsonFile, root);
+    ContractInfo info;
+    for (auto const& contract: root.get_child("contracts"))
+        if (boost::ends_with(contract.first, _contractName))
+        {
+            info.contractName = contract.first;
+            break;
+        }
+    BOOST_REQUIRE(!info.contractName.empty());
+    auto const path = [&](string const& _field) {
+        return pt::ptree::path_type("contracts|" + info.contractName + "|" + _field, '|');
+    };
+    info.abiJson = root.get<string>(path("abi"));
+    info.bin = root.get<string>(path("bin"));
+    info.binRuntime = root.get<string>(path("bin-runtime"));
+    info.srcmap = root.get<string>(path("srcmap"));
+    info.srcmapRuntime = root.get<string>(path("srcmap-runtime"));
+    for (auto const& source: root.get_child("sources"))
+    {
+        vector<pt::ptree> stack{source.second.get_child("AST")};
+        while (!stack.empty())
+        {
+            pt::ptree const item = stack.back();
+            stack.pop_back();
+            if (item.get<string>("name") == "FunctionDefinition" && item.get<bool>("attributes.constant"))
+                info.constantFunctionSrcmap.push_back(item.get<string>("src"));
+            if (auto children = item.get_child_optional("children"))
+                for (auto const& child: *children)
+                    stack.push_back(child.second);
+        }
+    }
+    return info;
+}
+
+void checkSameContract(string const& _jsonFile, string const& _contractName)
+{
+    ContractInfo const streamed = parseJson(_jsonFile, _contractName, true);
+    ContractInfo const tree = parseJsonTree(_jsonFile, _contractName);
+    BOOST_CHECK_EQUAL(streamed.contractName, tree.contractName);
+    BOOST_CHECK_EQUAL(streamed.abiJson, tree.abiJson);
+    BOOST_CHECK_EQUAL(streamed.bin, tree.bin);
+    BOOST_CHECK_EQUAL(streamed.binRuntime, tree.binRuntime);
+    BOOST_CHECK_EQUAL(streamed.srcmap, tree.srcmap);
+    BOOST_CHECK_EQUAL(streamed.srcmapRuntime, tree.srcmapRuntime);
+    BOOST_CHECK(streamed.isMain);
+    // The tree was walked depth first from the last child, the reader collects nodes as they close
+    vector<string> streamedConstants = streamed.constantFunctionSrcmap;
+    vector<string> treeConstants = tree.constantFunctionSrcmap;
+    sort(streamedConstants.begin(), streamedConstants.end());
+    sort(treeConstants.begin(), treeConstants.end());
+    BOOST_CHECK(streamedConstants == treeConstants);
+}
+}
+
+BOOST_FIXTURE_TEST_SUITE(FuzzerUtilsTests, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(stripSwarmMetadata)
+{
+    bytes const code = fromHex(c_constructor + c_runtime);
+    BOOST_CHECK(stripMetadata(fromHex(c_constructor + c_runtime + c_swarmMetadata)) == code);
+}
+
+BOOST_AUTO_TEST_CASE(stripIpfsMetadata)
+{
+    bytes const code = fromHex(c_constructor + c_runtime);
+    BOOST_CHECK(stripMetadata(fromHex(c_constructor + c_runtime + c_ipfsMetadata)) == code);
+}
+
+BOOST_AUTO_TEST_CASE(keepCodeWithoutMetadata)
+{
+    bytes const code = fromHex(c_constructor + c_runtime);
+    BOOST_CHECK(stripMetadata(code) == code);
+    BOOST_CHECK(stripMetadata(bytes{}) == bytes{});
+    BOOST_CHECK(stripMetadata(bytes{0x00}) == bytes{0x00});
+    // A length that fits but does not point at a CBOR map
+    bytes const tail = fromHex("600160020002");
+    BOOST_CHECK(stripMetadata(tail) == tail);
+}
+
+BOOST_AUTO_TEST_CASE(fingerprintIgnoresMetadata)
+{
+    Fingerprint const swarm = fingerprint(contract(c_constructor, c_swarmMetadata));
+    Fingerprint const ipfs = fingerprint(contract(c_constructor, c_ipfsMetadata));
+    BOOST_CHECK_EQUAL(swarm.stripped, ipfs.stripped);
+    BOOST_CHECK_EQUAL(swarm.signatures, ipfs.signatures);
+}
+
+BOOST_AUTO_TEST_CASE(fingerprintTellsConstructorsApart)
+{
+    ContractInfo const plain = contract(c_constructor, c_swarmMetadata);
+    ContractInfo const storing = contract(c_storingConstructor, c_swarmMetadata);
+    BOOST_REQUIRE_EQUAL(plain.binRuntime, storing.binRuntime);
+
+    Fingerprint const a = fingerprint(plain);
+    Fingerprint const b = fingerprint(storing);
+    BOOST_CHECK_NE(a.stripped, b.stripped);
+    BOOST_CHECK_EQUAL(a.signatures, b.signatures);
+}
+
+BOOST_AUTO_TEST_CASE(combinedJsonMatchesTreeTraversal)
+{
+    string const root = SFUZZ_SOURCE_DIR "/../";
+    checkSameContract(root + "contracts/GuessEth.sol.json", "GuessEth");
+    checkSameContract(root + "assets/ReentrancyAttacker.sol.json", "ReentrancyAttacker");
+
+    // GuessEthEvents must not shadow GuessEth, the name has to end the key
+    ContractInfo const main = parseJson(root + "contracts/GuessEth.sol.json", "GuessEth", false);
+    BOOST_CHECK_EQUAL(main.contractName, "contracts/GuessEth.sol:GuessEth");
+    BOOST_CHECK(!main.constantFunctionSrcmap.empty());
+    BOOST_CHECK(!main.bin.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,98 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SHA3.cpp
+ * Batched sha3 against the scalar one.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/SHA3.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+bytes input(size_t _size, unsigned _seed)
+{
+	bytes ret(_size);
+	for (size_t i = 0; i < _size; ++i)
+		ret[i] = byte(_seed * 31 + i * 7);
+	return ret;
+}
+
+/// Hashes @a _sizes in one batch and checks every hash against the scalar sha3.
+void checkBatch(vector<size_t> const& _sizes)
+{
+	vector<bytes> inputs;
+	for (size_t i = 0; i < _sizes.size(); ++i)
+		inputs.push_back(input(_sizes[i], unsigned(i)));
+	vector<bytesConstRef> refs;
+	for (auto const& i: inputs)
+		refs.push_back(bytesConstRef(&i));
+	vector<h256> hashes(refs.size());
+	sha3(refs.data(), hashes.data(), refs.size());
+	for (size_t i = 0; i < inputs.size(); ++i)
+		BOOST_CHECK_MESSAGE(hashes[i] == sha3(inputs[i]), "input " << i << " of " << inputs[i].size() << " bytes");
+}
+}
+
+BOOST_FIXTURE_TEST_SUITE(SHA3Tests, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(scalarEmpty)
+{
+	BOOST_CHECK_EQUAL(sha3(bytes()), h256("c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"));
+}
+
+BOOST_AUTO_TEST_CASE(batchSameBlockCount)
+{
+	// Around the 136 byte rate: no full block, one and two
+	checkBatch({0, 64, 135, 100});
+	checkBatch({136, 137, 200, 271});
+	checkBatch({272, 300, 400, 407});
+	checkBatch({0, 0, 0, 0, 64, 64, 64, 64});
+}
+
+BOOST_AUTO_TEST_CASE(batchMixedBlockCount)
+{
+	checkBatch({0, 64, 135, 136});
+	checkBatch({137, 272, 0, 64});
+	checkBatch({272, 0, 136, 135, 64, 137, 0, 272});
+}
+
+BOOST_AUTO_TEST_CASE(batchScalarTail)
+{
+	for (size_t count = 0; count < 8; ++count)
+	{
+		vector<size_t> sizes;
+		for (size_t i = 0; i < count; ++i)
+			sizes.push_back(vector<size_t>{0, 64, 135, 136, 137, 272}[i % 6]);
+		checkBatch(sizes);
+	}
+	checkBatch({64, 64, 64, 64, 64});
+	checkBatch({136, 136, 136, 136, 136, 136, 136});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
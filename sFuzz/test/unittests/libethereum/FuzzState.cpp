@@ -0,0 +1,266 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/// @file
+/// FuzzState unit tests.
+
+#include <test/tools/libtesteth/TestHelper.h>
+#include <libethereum/FuzzState.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+Address const c_contract{"2222222222222222222222222222222222222222"};
+Address const c_attacker{"3333333333333333333333333333333333333333"};
+Address const c_sender{"4444444444444444444444444444444444444444"};
+bytes const c_runtime{0x60, 0x00, 0x35, 0x60, 0x00, 0x55, 0x00};
+
+/// Sets up accounts the way TargetContainer does before the first execution.
+void deploy(FuzzState& _s)
+{
+    _s.setBalance(c_sender, 1000);
+    _s.setBalance(c_attacker, 10);
+    _s.setCode(c_attacker, bytes{0x00});
+    _s.setCode(c_contract, bytes(c_runtime));
+    _s.setStorage(c_contract, 0, 1);
+    _s.setStorage(c_contract, 1, 2);
+}
+
+/// Changes a TargetExecutive::exec could make: transfers, nonces, storage, creation and selfdestruct.
+void execute(FuzzState& _s, unsigned _i)
+{
+    _s.incNonce(c_sender);
+    _s.subBalance(c_sender, 5);
+    _s.addBalance(c_contract, 5);
+    _s.setStorage(c_contract, 0, _i);
+    _s.setStorage(c_contract, _i + 2, 3);
+    Address const created{u160(_i + 0x100)};
+    _s.setCode(created, bytes{0x60, byte(_i), 0x00});
+    _s.setStorage(created, 0, _i);
+    if (_i % 3 == 0)
+        _s.clearStorage(c_contract);
+    if (_i % 5 == 0)
+        _s.kill(c_attacker);
+    if (_i % 7 == 0)
+        _s.setCode(c_contract, bytes{0x00});
+}
+
+void checkSameState(FuzzState const& _a, FuzzState const& _b, vector<Address> const& _addresses)
+{
+    BOOST_CHECK(_a.addresses() == _b.addresses());
+    for (auto const& addr: _addresses)
+    {
+        BOOST_CHECK_EQUAL(_a.addressInUse(addr), _b.addressInUse(addr));
+        BOOST_CHECK_EQUAL(_a.balance(addr), _b.balance(addr));
+        BOOST_CHECK_EQUAL(_a.getNonce(addr), _b.getNonce(addr));
+        BOOST_CHECK(_a.code(addr) == _b.code(addr));
+        BOOST_CHECK_EQUAL(_a.codeHash(addr), _b.codeHash(addr));
+        BOOST_CHECK(_a.storage(addr) == _b.storage(addr));
+    }
+}
+}
+
+BOOST_FIXTURE_TEST_SUITE(FuzzStateTests, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(execRollbackKeepsStorageBounded)
+{
+    Address addr{"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
+    FuzzState s{0};
+    // Written outside any savepoint, like the attacker deployment, so the changelog is never empty
+    s.setStorage(addr, 0xff, 7);
+    for (unsigned i = 0; i < 20000; ++i)
+    {
+        size_t const base = s.baseSavepoint();
+        size_t const inner = s.savepoint();
+        s.setStorage(addr, i, i + 1);
+        s.setStorage(addr, i + 1000000, 1);
+        s.rollback(inner);
+        s.rollback(base);
+        BOOST_REQUIRE_LE(s.storageSize(), 4096);
+    }
+    BOOST_CHECK_EQUAL(s.storage(addr, 0xff), 7);
+    BOOST_CHECK_EQUAL(s.storage(addr, 19999), 0);
+    BOOST_CHECK_EQUAL(s.storage(addr).size(), 1);
+
+    // Entries left below the base still restore the right slots after compaction
+    s.rollback(0);
+    BOOST_CHECK_EQUAL(s.storage(addr, 0xff), 0);
+    BOOST_CHECK(s.storage(addr).empty());
+}
+
+BOOST_AUTO_TEST_CASE(compactionKeepsSlotsAnEpochChangeRestores)
+{
+    Address addr{"bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb"};
+    FuzzState s{0};
+    s.setStorage(addr, 1, 5);
+    size_t const beforeClear = s.savepoint();
+    s.clearStorage(addr);
+    BOOST_CHECK_EQUAL(s.storage(addr, 1), 0);
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        size_t const base = s.baseSavepoint();
+        s.setStorage(addr, i + 100, 1);
+        s.rollback(base);
+    }
+    BOOST_CHECK_LE(s.storageSize(), 4096);
+    s.rollback(beforeClear);
+    BOOST_CHECK_EQUAL(s.storage(addr, 1), 5);
+}
+
+BOOST_AUTO_TEST_CASE(rollbackRestoresBalanceAndNonce)
+{
+    Address addr{"cccccccccccccccccccccccccccccccccccccccc"};
+    FuzzState s{0};
+    s.setBalance(addr, 100);
+    s.setNonce(addr, 3);
+    size_t const sp = s.savepoint();
+    s.addBalance(addr, 5);
+    s.subBalance(addr, 50);
+    s.incNonce(addr);
+    s.incNonce(addr);
+    BOOST_CHECK_EQUAL(s.balance(addr), 55);
+    BOOST_CHECK_EQUAL(s.getNonce(addr), 5);
+    s.rollback(sp);
+    BOOST_CHECK_EQUAL(s.balance(addr), 100);
+    BOOST_CHECK_EQUAL(s.getNonce(addr), 3);
+
+    // The values are logged again after the rollback
+    size_t const again = s.savepoint();
+    s.setBalance(addr, 1);
+    s.rollback(again);
+    BOOST_CHECK_EQUAL(s.balance(addr), 100);
+}
+
+BOOST_AUTO_TEST_CASE(rollbackRestoresCode)
+{
+    Address addr{"dddddddddddddddddddddddddddddddddddddddd"};
+    bytes const code{0x60, 0x00, 0x56};
+    FuzzState s{0};
+    s.setCode(addr, bytes(code));
+    size_t const sp = s.savepoint();
+    s.setCode(addr, bytes{0x00});
+    BOOST_CHECK(s.code(addr) == bytes{0x00});
+    s.rollback(sp);
+    BOOST_CHECK(s.code(addr) == code);
+    BOOST_CHECK_EQUAL(s.codeHash(addr), sha3(code));
+    BOOST_CHECK(s.addressHasCode(addr));
+
+    // Code set on a new account goes away with the account
+    Address fresh{"eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"};
+    size_t const beforeCreate = s.savepoint();
+    s.setCode(fresh, bytes(code));
+    BOOST_CHECK(s.addressInUse(fresh));
+    s.rollback(beforeCreate);
+    BOOST_CHECK(!s.addressInUse(fresh));
+    BOOST_CHECK(s.code(fresh).empty());
+    BOOST_CHECK_EQUAL(s.codeHash(fresh), EmptySHA3);
+}
+
+BOOST_AUTO_TEST_CASE(rollbackRevivesKilledAccount)
+{
+    Address addr{"ffffffffffffffffffffffffffffffffffffffff"};
+    bytes const code{0x60, 0x01, 0x00};
+    FuzzState s{0};
+    s.setBalance(addr, 7);
+    s.setNonce(addr, 2);
+    s.setCode(addr, bytes(code));
+    s.setStorage(addr, 1, 9);
+    size_t const sp = s.savepoint();
+    s.kill(addr);
+    BOOST_CHECK(!s.addressInUse(addr));
+    BOOST_CHECK_EQUAL(s.balance(addr), 0);
+    BOOST_CHECK_EQUAL(s.storage(addr, 1), 0);
+    s.rollback(sp);
+    BOOST_CHECK(s.addressInUse(addr));
+    BOOST_CHECK_EQUAL(s.balance(addr), 7);
+    BOOST_CHECK_EQUAL(s.getNonce(addr), 2);
+    BOOST_CHECK(s.code(addr) == code);
+    BOOST_CHECK_EQUAL(s.storage(addr, 1), 9);
+    BOOST_CHECK_EQUAL(s.storage(addr).size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(nestedSavepoints)
+{
+    Address addr{"1111111111111111111111111111111111111111"};
+    FuzzState s{0};
+    s.setBalance(addr, 1);
+    s.setStorage(addr, 0, 1);
+    size_t const outer = s.savepoint();
+    s.setBalance(addr, 2);
+    s.setStorage(addr, 0, 2);
+    size_t const middle = s.savepoint();
+    s.setBalance(addr, 3);
+    s.setStorage(addr, 0, 3);
+    s.setStorage(addr, 1, 3);
+    size_t const inner = s.savepoint();
+    s.kill(addr);
+
+    s.rollback(inner);
+    BOOST_CHECK_EQUAL(s.balance(addr), 3);
+    BOOST_CHECK_EQUAL(s.storage(addr, 1), 3);
+    s.rollback(middle);
+    BOOST_CHECK_EQUAL(s.balance(addr), 2);
+    BOOST_CHECK_EQUAL(s.storage(addr, 0), 2);
+    BOOST_CHECK_EQUAL(s.storage(addr, 1), 0);
+
+    // A new nested savepoint after a partial rollback
+    size_t const second = s.savepoint();
+    s.setBalance(addr, 4);
+    s.rollback(second);
+    BOOST_CHECK_EQUAL(s.balance(addr), 2);
+    s.rollback(outer);
+    BOOST_CHECK_EQUAL(s.balance(addr), 1);
+    BOOST_CHECK_EQUAL(s.storage(addr, 0), 1);
+}
+
+BOOST_AUTO_TEST_CASE(resetMatchesFreshDeployment)
+{
+    FuzzState fresh{0};
+    deploy(fresh);
+
+    FuzzState reused{0};
+    deploy(reused);
+    vector<Address> addresses{c_contract, c_attacker, c_sender};
+    // Enough executions for the storage table to be compacted on the way
+    for (unsigned i = 0; i < 5000; ++i)
+    {
+        size_t const base = reused.baseSavepoint();
+        execute(reused, i);
+        reused.rollback(base);
+        if (i < 16)
+            addresses.push_back(Address{u160(i + 0x100)});
+    }
+    checkSameState(reused, fresh, addresses);
+    BOOST_CHECK_LE(reused.storageSize(), 4096);
+
+    // Both give the same result for the next execution
+    execute(fresh, 1);
+    execute(reused, 1);
+    checkSameState(reused, fresh, addresses);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
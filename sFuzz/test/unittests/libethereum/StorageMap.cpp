@@ -0,0 +1,157 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/// @file
+/// StorageMap unit tests.
+
+#include <test/tools/libtesteth/TestHelper.h>
+#include <libethereum/StorageMap.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+/// Keys spread over the limbs so the index sees distinct hashes.
+u256 key(unsigned _i)
+{
+    return (u256(_i) << 192) + _i * 7;
+}
+
+vector<u256> keys(StorageMap const& _map)
+{
+    vector<u256> ret;
+    for (auto const& entry: _map)
+        ret.push_back(entry.first);
+    return ret;
+}
+
+void fill(StorageMap& _map, unsigned _count)
+{
+    for (unsigned i = 0; i < _count; ++i)
+        _map[key(i)] = i + 1;
+}
+
+void checkFilled(StorageMap const& _map, unsigned _count)
+{
+    BOOST_REQUIRE_EQUAL(_map.size(), _count);
+    for (unsigned i = 0; i < _count; ++i)
+    {
+        auto it = _map.find(key(i));
+        BOOST_REQUIRE(it != _map.end());
+        BOOST_CHECK_EQUAL(it->second, i + 1);
+    }
+    BOOST_CHECK(_map.find(key(_count)) == _map.end());
+}
+}
+
+BOOST_FIXTURE_TEST_SUITE(StorageMapTests, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(findAcrossSmallSize)
+{
+    StorageMap map;
+    BOOST_CHECK(map.empty());
+    for (unsigned count = 1; count <= StorageMap::c_smallSize * 8; ++count)
+    {
+        map[key(count - 1)] = count;
+        checkFilled(map, count);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(iterateInInsertionOrder)
+{
+    unsigned const count = StorageMap::c_smallSize + 3;
+    StorageMap map;
+    vector<u256> expected;
+    for (unsigned i = count; i > 0; --i)
+    {
+        map[key(i)] = i;
+        expected.push_back(key(i));
+        BOOST_CHECK(keys(map) == expected);
+    }
+    // Assigning an existing key keeps its position
+    map[key(count)] = 0;
+    BOOST_CHECK(keys(map) == expected);
+    BOOST_CHECK_EQUAL(map.begin()->second, 0);
+}
+
+BOOST_AUTO_TEST_CASE(eraseMovesLastEntry)
+{
+    for (unsigned count: {unsigned(StorageMap::c_smallSize), unsigned(StorageMap::c_smallSize * 4)})
+    {
+        StorageMap map;
+        fill(map, count);
+        BOOST_CHECK_EQUAL(map.erase(key(count)), 0);
+        BOOST_CHECK_EQUAL(map.erase(key(2)), 1);
+        BOOST_CHECK_EQUAL(map.erase(key(2)), 0);
+        BOOST_REQUIRE_EQUAL(map.size(), count - 1);
+        BOOST_CHECK(map.find(key(2)) == map.end());
+        BOOST_CHECK_EQUAL(keys(map)[2], key(count - 1));
+
+        // Every other key is still found after the erase shifted the probes
+        for (unsigned i = 0; i < count; i += 2)
+            map.erase(key(i));
+        for (unsigned i = 1; i < count; i += 2)
+        {
+            auto it = map.find(key(i));
+            BOOST_REQUIRE(it != map.end());
+            BOOST_CHECK_EQUAL(it->second, i + 1);
+        }
+        BOOST_CHECK_EQUAL(map.size(), count / 2);
+
+        // Erased keys come back at the end
+        map[key(0)] = 42;
+        BOOST_CHECK_EQUAL(keys(map).back(), key(0));
+        BOOST_CHECK_EQUAL(map.find(key(0))->second, 42);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(copyAndMove)
+{
+    for (unsigned count: {unsigned(StorageMap::c_smallSize), unsigned(StorageMap::c_smallSize + 1)})
+    {
+        StorageMap map;
+        fill(map, count);
+        StorageMap copy = map;
+        checkFilled(copy, count);
+        BOOST_CHECK(keys(copy) == keys(map));
+
+        copy[key(0)] = 0;
+        BOOST_CHECK_EQUAL(map.find(key(0))->second, 1);
+
+        StorageMap moved = move(map);
+        checkFilled(moved, count);
+        BOOST_CHECK(map.empty());
+
+        moved = copy;
+        BOOST_CHECK_EQUAL(moved.find(key(0))->second, 0);
+        moved.clear();
+        BOOST_CHECK(moved.empty());
+        fill(moved, 3);
+        checkFilled(moved, 3);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
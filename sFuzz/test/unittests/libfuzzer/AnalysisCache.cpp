@@ -0,0 +1,201 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/// @file
+/// Static analysis cache of the fuzzer.
+
+#include <test/tools/libtesteth/TestHelper.h>
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libfuzzer/AnalysisCache.h>
+
+using namespace std;
+using namespace dev;
+using namespace fuzzer;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+ContractInfo contract()
+{
+    ContractInfo info;
+    info.abiJson = "[]";
+    info.bin = "6080604052";
+    info.binRuntime = "6080";
+    info.srcmap = "0:10:0:-";
+    info.srcmapRuntime = "0:4:0:-";
+    info.source = "contract A {}";
+    info.constantFunctionSrcmap = {"1:2:0"};
+    info.isMain = true;
+    return info;
+}
+
+StaticAnalysis analysis(h256 const& _key)
+{
+    StaticAnalysis ret;
+    ret.key = _key;
+    ret.deploymentJumpis = {12, 40};
+    // Above 32 bits, the pcs must not be narrowed on the way
+    ret.runtimeJumpis = {9, (uint64_t(1) << 40) + 3};
+    ret.snippets = {{9, "x <= 5"}, {40, "msg.value > 0"}};
+    ret.codeValues = {bytes{0x01}, bytes(32, 0xff)};
+    ret.selectors = {bytes{0xa9, 0x05, 0x9c, 0xbb}};
+    ret.eventHashes = {{"ddf252ad", "Transfer(address,address,uint256)"}};
+    return ret;
+}
+
+void checkSame(StaticAnalysis const& _a, StaticAnalysis const& _b)
+{
+    BOOST_CHECK_EQUAL(_a.key, _b.key);
+    BOOST_CHECK(_a.deploymentJumpis == _b.deploymentJumpis);
+    BOOST_CHECK(_a.runtimeJumpis == _b.runtimeJumpis);
+    BOOST_CHECK(_a.snippets == _b.snippets);
+    BOOST_CHECK(_a.codeValues == _b.codeValues);
+    BOOST_CHECK(_a.selectors == _b.selectors);
+    BOOST_CHECK(_a.eventHashes == _b.eventHashes);
+}
+
+/// Loads @a _path and checks it is rejected without touching the analysis.
+void checkRejected(string const& _path, h256 const& _key)
+{
+    StaticAnalysis loaded = analysis(h256(1));
+    bool ok = true;
+    BOOST_CHECK_NO_THROW(ok = AnalysisCache::load(_path, _key, loaded));
+    BOOST_CHECK(!ok);
+    checkSame(loaded, analysis(h256(1)));
+}
+}
+
+BOOST_FIXTURE_TEST_SUITE(AnalysisCacheTests, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(saveThenLoad)
+{
+    TransientDirectory dir;
+    string const path = dir.path() + "/A.sol.json.analysis";
+    h256 const key = AnalysisCache::keyOf(contract());
+    AnalysisCache::save(path, analysis(key));
+
+    StaticAnalysis loaded;
+    BOOST_REQUIRE(AnalysisCache::load(path, key, loaded));
+    checkSame(loaded, analysis(key));
+
+    // Saving again replaces the file
+    StaticAnalysis empty;
+    empty.key = key;
+    AnalysisCache::save(path, empty);
+    BOOST_REQUIRE(AnalysisCache::load(path, key, loaded));
+    checkSame(loaded, empty);
+}
+
+BOOST_AUTO_TEST_CASE(keyCoversEveryInput)
+{
+    h256 const key = AnalysisCache::keyOf(contract());
+    BOOST_CHECK_EQUAL(key, AnalysisCache::keyOf(contract()));
+    vector<function<void(ContractInfo&)>> const changes{
+        [](ContractInfo& _c) { _c.bin += "00"; },
+        [](ContractInfo& _c) { _c.binRuntime += "00"; },
+        [](ContractInfo& _c) { _c.srcmap += ";"; },
+        [](ContractInfo& _c) { _c.srcmapRuntime += ";"; },
+        [](ContractInfo& _c) { _c.source += " "; },
+        [](ContractInfo& _c) { _c.abiJson = "[ ]"; },
+        [](ContractInfo& _c) { _c.constantFunctionSrcmap.clear(); },
+    };
+    for (auto const& change: changes)
+    {
+        ContractInfo changed = contract();
+        change(changed);
+        BOOST_CHECK_NE(AnalysisCache::keyOf(changed), key);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rejectOtherKey)
+{
+    TransientDirectory dir;
+    string const path = dir.path() + "/A.sol.json.analysis";
+    h256 const key = AnalysisCache::keyOf(contract());
+    AnalysisCache::save(path, analysis(key));
+    ContractInfo changed = contract();
+    changed.bin += "00";
+    checkRejected(path, AnalysisCache::keyOf(changed));
+}
+
+BOOST_AUTO_TEST_CASE(rejectOtherVersion)
+{
+    TransientDirectory dir;
+    string const path = dir.path() + "/A.sol.json.analysis";
+    h256 const key = AnalysisCache::keyOf(contract());
+    AnalysisCache::save(path, analysis(key));
+
+    // Same layout, written by another version
+    bytes const data = contents(path);
+    RLP const saved(data);
+    RLPStream s(saved.itemCount());
+    s << ANALYSIS_CACHE_VERSION + 1;
+    for (size_t i = 1; i < saved.itemCount(); ++i)
+        s.appendRaw(saved[i].data());
+    writeFile(path, s.out());
+    checkRejected(path, key);
+}
+
+BOOST_AUTO_TEST_CASE(fallBackOnBrokenFile)
+{
+    TransientDirectory dir;
+    string const path = dir.path() + "/A.sol.json.analysis";
+    h256 const key = AnalysisCache::keyOf(contract());
+    checkRejected(path, key);
+
+    AnalysisCache::save(path, analysis(key));
+    bytes const saved = contents(path);
+    for (size_t size: {size_t(1), size_t(40), saved.size() / 2, saved.size() - 1})
+    {
+        writeFile(path, bytes(saved.begin(), saved.begin() + size));
+        checkRejected(path, key);
+    }
+
+    writeFile(path, asBytes("not rlp at all"));
+    checkRejected(path, key);
+
+    // Well formed RLP of the wrong shape
+    RLPStream shortList(2);
+    shortList << ANALYSIS_CACHE_VERSION << key;
+    writeFile(path, shortList.out());
+    checkRejected(path, key);
+
+    RLP const good(saved);
+    RLPStream wrongItem(good.itemCount());
+    for (size_t i = 0; i < good.itemCount(); ++i)
+        if (i == 2)
+            wrongItem << "jumpis";
+        else
+            wrongItem.appendRaw(good[i].data());
+    writeFile(path, wrongItem.out());
+    checkRejected(path, key);
+
+    // A broken file is replaced by the next fresh analysis
+    AnalysisCache::save(path, analysis(key));
+    StaticAnalysis loaded;
+    BOOST_CHECK(AnalysisCache::load(path, key, loaded));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,137 @@
+/*
+    This file is part of cpp-ethereum.
+
+    cpp-ethereum is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    cpp-ethereum is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/// @file
+/// TargetExecutive runs under LegacyVM and under the EVMC interpreter.
+
+#include <test/tools/libtesteth/TestHelper.h>
+#include <libfuzzer/TargetContainer.h>
+#include <boost/program_options.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace fuzzer;
+namespace po = boost::program_options;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+/// f(uint x): stores x at 1 if x <= 5, else x + caller at 0. The JUMPI is at runtime pc 9.
+string const c_branchyBin =
+    "601580600b6000396000f3"
+    "60043580600510600e57600155005b330160005500";
+string const c_branchyAbi =
+    R"([{"constant":false,"inputs":[{"name":"x","type":"uint256"}],"name":"f","outputs":[],)"
+    R"("payable":false,"stateMutability":"nonpayable","type":"function"}])";
+
+/// A constructor jumping back to its first instruction forever.
+string const c_loopBin = "5b600056";
+
+void selectVM(string const& _name)
+{
+    char const* argv[] = {"testeth", "--vm", _name.c_str()};
+    po::variables_map vm;
+    po::store(po::parse_command_line(3, argv, vmProgramOptions()), vm);
+    po::notify(vm);
+}
+
+struct ExecTrace
+{
+    unordered_set<string> tracebits;
+    unordered_map<string, u256> predicates;
+    unordered_set<string> uniqExceptions;
+    vector<vector<tuple<u256, Instruction, bool, bool, bool>>> events;
+};
+
+/// Runs f(x) for each of @a _xs on a fresh container of the @a _vm VM.
+ExecTrace runBranchy(string const& _vm, vector<unsigned> const& _xs)
+{
+    selectVM(_vm);
+    TargetContainer container;
+    ContractABI ca(c_branchyAbi);
+    auto executive = container.loadContract(fromHex(c_branchyBin), ca);
+    executive.ca.setExecutionOrder({"1"});
+    auto const validJumpis =
+        make_tuple(unordered_set<uint64_t>{}, unordered_set<uint64_t>{9});
+    ExecTrace trace;
+    for (auto x: _xs)
+    {
+        bytes data(128, 0);
+        data[127] = byte(x);
+        auto res = executive.exec(ContractABI::postprocessTestData(data), validJumpis);
+        trace.tracebits.insert(res.tracebits.begin(), res.tracebits.end());
+        trace.predicates.insert(res.predicates.begin(), res.predicates.end());
+        trace.uniqExceptions.insert(res.uniqExceptions.begin(), res.uniqExceptions.end());
+    }
+    for (auto const& function: container.oracleFactory->events())
+    {
+        trace.events.emplace_back();
+        for (auto const& ctx: function)
+            trace.events.back().emplace_back(ctx.payload.pc, ctx.payload.inst,
+                ctx.payload.isOverflow, ctx.payload.isUnderflow, ctx.payload.isSstore);
+    }
+    selectVM("legacy");
+    return trace;
+}
+
+/// @returns the instructions the constructor of c_loopBin ran before it was cut.
+uint64_t runLoop(string const& _vm)
+{
+    selectVM(_vm);
+    TargetContainer container;
+    ContractABI ca("[]");
+    auto executive = container.loadContract(fromHex(c_loopBin), ca);
+    auto const validJumpis = make_tuple(unordered_set<uint64_t>{}, unordered_set<uint64_t>{});
+    auto res = executive.exec(ContractABI::postprocessTestData(bytes(96, 0)), validJumpis);
+    BOOST_CHECK(res.hang.empty());
+    uint64_t const steps = LegacyVM::steps();
+    selectVM("legacy");
+    return steps;
+}
+}
+
+BOOST_FIXTURE_TEST_SUITE(TargetExecutiveTests, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(interpreterMatchesLegacyVM)
+{
+    vector<unsigned> const xs{3, 9};
+    ExecTrace const legacy = runBranchy("legacy", xs);
+    ExecTrace const interpreter = runBranchy("interpreter", xs);
+
+    BOOST_REQUIRE_EQUAL(legacy.tracebits.size(), 2);
+    BOOST_CHECK(legacy.tracebits == interpreter.tracebits);
+    BOOST_CHECK(legacy.predicates == interpreter.predicates);
+    BOOST_CHECK(legacy.uniqExceptions == interpreter.uniqExceptions);
+    BOOST_REQUIRE(!legacy.events.empty());
+    BOOST_CHECK(legacy.events == interpreter.events);
+}
+
+BOOST_AUTO_TEST_CASE(interpreterStopsAtStepLimit)
+{
+    // Without the limit the loop runs until the call's MAX_GAS is spent.
+    BOOST_CHECK_EQUAL(runLoop("legacy"), STEP_LIMIT_MIN + 1);
+    BOOST_CHECK_EQUAL(runLoop("interpreter"), STEP_LIMIT_MIN + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
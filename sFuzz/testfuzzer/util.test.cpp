@@ -18,12 +18,21 @@ TEST(Util, DISABLED_swap16)
 }
 TEST(Util, DISABLED_f)
 {
-  EXPECT_EQ(effAPos(20), 2);
-  EXPECT_EQ(effRem(20), 4);
-  EXPECT_EQ(effALen(20), 3);
+  EXPECT_EQ(effAPos(70), 2);
+  EXPECT_EQ(effRem(70), 6);
+  EXPECT_EQ(effALen(70), 3);
 }
 
 TEST(Util, DISABLED_CouldBeBitflip)
 {
   EXPECT_EQ(couldBeBitflip(32), true);
 }
+
+TEST(Util, DISABLED_BigEndian)
+{
+  bytes data(32, 0);
+  EXPECT_TRUE(writeBE(data, 24, 8, 0x0102));
+  EXPECT_EQ(data[30], 0x01);
+  EXPECT_EQ(readBE(data, 0, 32), 0x0102);
+  EXPECT_FALSE(writeBE(data, 0, 1, 0x100));
+}
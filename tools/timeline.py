@@ -0,0 +1,148 @@
+"""
+Time-to-coverage harness.
+
+  python3 tools/timeline.py run --out runs/base --seed 1 --duration 300 --llm llm/
+      fuzzes every compiled contract of contracts/ and source/ headless with a
+      fixed seed, writing the stats of runs/base/<contract>.csv every second. The LLM answers are replayed
+      from llm/<contract>.jsonl, pass --record to fill them from the live API first.
+
+  python3 tools/timeline.py compare runs/base runs/new --levels 50 80 90
+      reports per contract and in total the area under the coverage curve and
+      the time each run needs to reach every coverage level.
+"""
+import argparse
+import csv
+import os
+import subprocess
+import sys
+
+CORPUS = ["contracts", "source"]
+
+
+def contracts(folders):
+    for folder in folders:
+        if not os.path.isdir(folder):
+            continue
+        for root, _, files in os.walk(folder):
+            for name in sorted(files):
+                path = os.path.join(root, name)
+                if name.endswith(".sol") and os.path.exists(path + ".json"):
+                    # Same contract name as fuzzer -g gives
+                    yield path, name.split(".")[0].split("_0x")[0]
+
+
+def run(args):
+    os.makedirs(args.out, exist_ok=True)
+    if args.llm:
+        os.makedirs(args.llm, exist_ok=True)
+    for source, name in contracts(args.contracts):
+        print(">> " + name)
+        stats = os.path.join(args.out, name + ".csv")
+        # The fuzzer appends to its stats file
+        if os.path.exists(stats):
+            os.remove(stats)
+        llm = []
+        if args.llm:
+            llm = ["--llm-record" if args.record else "--llm-replay", os.path.join(args.llm, name + ".jsonl")]
+        subprocess.call([
+            args.fuzzer,
+            "--file", source + ".json",
+            "--source", source,
+            "--name", name,
+            "--assets", args.assets,
+            "--duration", str(args.duration),
+            "--reporter", "1",
+            "--attacker", args.attacker,
+            "--seed", str(args.seed),
+            "--stats", stats,
+            "--stats-interval", "1",
+        ] + llm)
+
+
+def load(path):
+    # plot_data style: a "# " header, then ", " separated samples
+    with open(path) as f:
+        rows = list(csv.DictReader([line.lstrip("# ") for line in f], skipinitialspace=True))
+    # Coverage in percent of all branches over time, starting from nothing
+    points = [(0.0, 0.0)]
+    for row in rows:
+        total = int(row["total"])
+        covered = 100.0 * int(row["covered"]) / total if total else 0.0
+        points.append((float(row["time"]), covered))
+    vulns = bin(int(rows[-1]["vulnerabilities"])).count("1") if rows else 0
+    return points, vulns
+
+
+def auc(points, horizon):
+    # Step curve: coverage holds until the next sample, normalized to [0, 100]
+    area = 0.0
+    for (t0, c0), (t1, _) in zip(points, points[1:] + [(horizon, None)]):
+        t1 = min(t1, horizon)
+        if t1 > t0:
+            area += c0 * (t1 - t0)
+    return area / horizon if horizon else 0.0
+
+
+def reach(points, level):
+    for t, c in points:
+        if c >= level:
+            return t
+    return None
+
+
+def compare(args):
+    runs = [{name[:-len(".csv")]: load(os.path.join(run, name))
+             for name in os.listdir(run) if name.endswith(".csv")} for run in args.runs]
+    names = sorted(set.intersection(*[set(r) for r in runs]))
+    if not names:
+        sys.exit("no contract is shared by all runs")
+    horizon = args.horizon or max(r[name][0][-1][0] for r in runs for name in names)
+    header = ["contract", "run", "auc", "final", "vulns"] + ["t%d%%" % l for l in args.levels]
+    table = [header]
+    totals = [[0.0, 0.0, 0] for _ in runs]
+    for name in names:
+        for i, r in enumerate(runs):
+            points, vulns = r[name]
+            area = auc(points, horizon)
+            totals[i][0] += area
+            totals[i][1] += points[-1][1]
+            totals[i][2] += vulns
+            times = [reach(points, l) for l in args.levels]
+            table.append([name, args.runs[i], "%.2f" % area, "%.2f" % points[-1][1], str(vulns)] +
+                         ["-" if t is None else "%.1f" % t for t in times])
+    for i, total in enumerate(totals):
+        table.append(["mean", args.runs[i], "%.2f" % (total[0] / len(names)),
+                      "%.2f" % (total[1] / len(names)), str(total[2])] + [""] * len(args.levels))
+    widths = [max(len(row[c]) for row in table) for c in range(len(header))]
+    for row in table:
+        print("  ".join(cell.ljust(w) for cell, w in zip(row, widths)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command")
+    p = sub.add_parser("run")
+    p.add_argument("--out", required=True)
+    p.add_argument("--fuzzer", default="./fuzzer")
+    p.add_argument("--contracts", nargs="+", default=CORPUS)
+    p.add_argument("--assets", default="assets/")
+    p.add_argument("--attacker", default="ReentrancyAttacker")
+    p.add_argument("--duration", type=int, default=120)
+    p.add_argument("--seed", type=int, default=1)
+    p.add_argument("--llm", help="folder of LLM record files, replayed unless --record")
+    p.add_argument("--record", action="store_true")
+    p = sub.add_parser("compare")
+    p.add_argument("runs", nargs="+")
+    p.add_argument("--levels", type=float, nargs="+", default=[50, 80, 90])
+    p.add_argument("--horizon", type=float, help="seconds the AUC covers (default: longest run)")
+    args = parser.parse_args()
+    if args.command == "run":
+        run(args)
+    elif args.command == "compare":
+        compare(args)
+    else:
+        parser.print_help()
+
+
+if __name__ == "__main__":
+    main()